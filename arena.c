@@ -0,0 +1,217 @@
+#include "defs.h"
+
+struct ArenaBlock {
+    ArenaBlockType *next;
+    size_t size;                // bytes of data after the header
+    size_t used;
+    int poolIndex;              // 1 + slot in poolBlocks, 0 for blocks the pool never takes
+    atomic_int poolNext;        // poolIndex of the block below this one on the pool stack
+    max_align_t data[];
+};
+
+// Standard blocks released by this thread's arenas, reused before asking malloc
+static __thread ArenaBlockType *blockCache = NULL;
+static __thread int cachedBlocks = 0;
+
+// Process-wide pool of standard blocks shared by all threads: a lock-free stack whose
+// head packs a change count above the poolIndex of the top block, so a pop that raced
+// with a pop and push of the same block fails its compare-and-swap instead of
+// corrupting the stack. Registered blocks are never freed, so a racing pop may always
+// read the next link of a block it no longer owns.
+static ArenaBlockType *poolBlocks[ARENA_POOL_BLOCKS];
+static atomic_int poolRegistered = 0;
+static atomic_ullong poolHead = 0;
+
+/*
+    Pushes a registered block onto the process-wide pool.
+        in:   block - the block to share, with a nonzero poolIndex
+*/
+static void poolPush(ArenaBlockType *block) {
+    unsigned long long head = atomic_load_explicit(&poolHead, memory_order_relaxed);
+    unsigned long long next;
+    do {
+        atomic_store_explicit(&block->poolNext, (int)(head & 0xFFFFFFFFu), memory_order_relaxed);
+        next = ((head >> 32) + 1) << 32 | (unsigned int)block->poolIndex;
+    } while (!atomic_compare_exchange_weak_explicit(&poolHead, &head, next, memory_order_release, memory_order_relaxed));
+}
+
+/*
+    Pops a block off the process-wide pool.
+    return:   a standard block, or NULL when the pool is empty
+*/
+static ArenaBlockType *poolPop() {
+    unsigned long long head = atomic_load_explicit(&poolHead, memory_order_acquire);
+    ArenaBlockType *block;
+    unsigned long long next;
+    do {
+        unsigned int index = (unsigned int)(head & 0xFFFFFFFFu);
+        if (index == 0) {
+            return NULL;
+        }
+        block = poolBlocks[index - 1];
+        next = ((head >> 32) + 1) << 32 | (unsigned int)atomic_load_explicit(&block->poolNext, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&poolHead, &head, next, memory_order_acquire, memory_order_acquire));
+    return block;
+}
+
+/*
+    Gives a newly allocated standard block a slot in the pool's registry, if one is left.
+        in/out: block - the block to register
+*/
+static void poolRegister(ArenaBlockType *block) {
+    block->poolIndex = 0;
+    atomic_init(&block->poolNext, 0);
+    if (atomic_load_explicit(&poolRegistered, memory_order_relaxed) >= ARENA_POOL_BLOCKS) {
+        return;
+    }
+    int slot = atomic_fetch_add_explicit(&poolRegistered, 1, memory_order_relaxed);
+    if (slot < ARENA_POOL_BLOCKS) {
+        poolBlocks[slot] = block;
+        block->poolIndex = slot + 1;
+    }
+}
+
+/*
+    Hands a standard block back, to this thread's cache while it has room, else to the
+    process-wide pool, else to malloc.
+        in:   block - the released block
+*/
+static void releaseBlock(ArenaBlockType *block) {
+    if (cachedBlocks < ARENA_CACHE_BLOCKS) {
+        block->next = blockCache;
+        blockCache = block;
+        cachedBlocks++;
+    } else if (block->poolIndex) {
+        poolPush(block);
+    } else {
+        free(block);
+    }
+}
+
+/*
+    Rounds a size up to the arena's alignment.
+        in:   size - the size in bytes
+    return:   the size rounded up to a multiple of ARENA_ALIGN
+*/
+static size_t arenaAlign(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+/*
+    Returns the bytes to skip in a block so its next allocation starts on a multiple of align.
+        in:   block - the block allocated from
+        in:   align - the alignment wanted, a power of two
+    return:   the padding in bytes
+*/
+static size_t arenaPadding(ArenaBlockType *block, size_t align) {
+    uintptr_t next = (uintptr_t)((char *)block->data + block->used);
+    return (size_t)((align - (next & (align - 1))) & (align - 1));
+}
+
+/*
+    Starts an empty arena. No memory is taken until the first allocation.
+        out:  arena - the arena to start
+*/
+void initArena(ArenaType *arena) {
+    arena->blocks = NULL;
+}
+
+/*
+    Returns size bytes from the arena, aligned for any type.
+        in/out: arena - the arena to allocate from
+        in:   size - the number of bytes wanted
+    return:   the allocated memory, released only by freeArena
+*/
+void *arenaAlloc(ArenaType *arena, size_t size) {
+    return arenaAllocAligned(arena, size, ARENA_ALIGN);
+}
+
+/*
+    Returns size bytes from the arena starting on a multiple of align. Allocations are carved
+    from the arena's current block; a new block comes from this thread's block cache,
+    then from the process-wide pool, and only then from malloc. Requests larger than a
+    standard block get a block of their own. Exits the program if memory runs out.
+        in/out: arena - the arena to allocate from
+        in:   size - the number of bytes wanted
+        in:   align - the alignment wanted, a power of two of at least ARENA_ALIGN
+    return:   the allocated memory, released only by freeArena
+*/
+void *arenaAllocAligned(ArenaType *arena, size_t size, size_t align) {
+    size = arenaAlign(size > 0 ? size : 1);
+
+    ArenaBlockType *block = arena->blocks;
+    size_t padding = block ? arenaPadding(block, align) : 0;
+    if (!block || block->size - block->used < padding + size) {
+        // A fresh block starts ARENA_ALIGN aligned, so at most align - ARENA_ALIGN is skipped
+        size += align - ARENA_ALIGN;
+        block = NULL;
+        if (size <= ARENA_BLOCK_SIZE && blockCache) {
+            block = blockCache;
+            blockCache = block->next;
+            cachedBlocks--;
+        } else if (size <= ARENA_BLOCK_SIZE) {
+            block = poolPop();
+        }
+        if (!block) {
+            size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+            block = (ArenaBlockType *)malloc(sizeof(ArenaBlockType) + blockSize);
+            if (!block) {
+                fprintf(stderr, "Error: Failed to allocate memory for an arena block.\n");
+                exit(EXIT_FAILURE);
+            }
+            block->size = blockSize;
+            if (blockSize == ARENA_BLOCK_SIZE) {
+                poolRegister(block);
+            } else {
+                block->poolIndex = 0;
+            }
+        }
+        block->used = 0;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        size -= align - ARENA_ALIGN;
+        padding = arenaPadding(block, align);
+    }
+
+    void *memory = (char *)block->data + block->used + padding;
+    block->used += padding + size;
+    return memory;
+}
+
+/*
+    Releases everything allocated from an arena in one go. Standard blocks are kept
+    in this thread's block cache, up to ARENA_CACHE_BLOCKS, for the next game, and
+    shared through the process-wide pool beyond that; the rest go back to malloc.
+        in/out: arena - the arena to release, left empty and reusable
+*/
+void freeArena(ArenaType *arena) {
+    ArenaBlockType *block = arena->blocks;
+    while (block) {
+        ArenaBlockType *next = block->next;
+        if (block->size == ARENA_BLOCK_SIZE) {
+            releaseBlock(block);
+        } else {
+            free(block);
+        }
+        block = next;
+    }
+    arena->blocks = NULL;
+}
+
+/*
+    Hands the blocks cached by the calling thread to the process-wide pool, or to
+    malloc when they have no pool slot. Threads that play games call this before
+    they exit.
+*/
+void releaseArenaCache() {
+    while (blockCache) {
+        ArenaBlockType *next = blockCache->next;
+        if (blockCache->poolIndex) {
+            poolPush(blockCache);
+        } else {
+            free(blockCache);
+        }
+        blockCache = next;
+    }
+    cachedBlocks = 0;
+}
@@ -0,0 +1,367 @@
+#include "defs.h"
+
+/**
+ * Parses the command line options for the non-interactive batch mode.
+ *
+ * Supported options:
+ *   --games N               number of complete games to play (default 1)
+ *   --names auto|a,b,c,d    hunter names; "auto" generates Hunter1..Hunter4 (default)
+ *   --log                   keep the per-action game log (off by default in batch mode)
+ *   --log-level LEVEL       off, info (set up, reviews and exits) or debug (the whole log, as --log)
+ *   --log-categories LIST   comma separated log categories to keep: init, hunter-move, ghost-move,
+ *                           hunter-evidence, ghost-evidence, review, exit, all or none
+ *   --engine NAME           threaded (one thread per entity, default), tick (fixed-tick
+ *                           scheduler), event (discrete-event simulation) or inline
+ *                           (fixed-tick loop without any locking) or soa
+ *                           (struct-of-arrays engine stepping many games in lockstep)
+ *   --lanes N               games stepped together by the soa engine (at most and by default SOA_LANES)
+ *   --seed S                master seed of every game's random streams (default: clock)
+ *   --workers N|auto        play games on a work-stealing pool of N threads (default 1)
+ *   --shards K              play games in K forked worker processes (default 1)
+ *   --bench rng             time the random generators instead of playing games
+ *   --trace FILE            write the game log to FILE as a binary trace, decoded by fp-trace
+ *                           (fp-trace --follow FILE decodes it while the games are still running);
+ *                           the whole log unless a level or categories are chosen
+ *
+ * The FP_LOG_LEVEL and FP_LOG_CATEGORIES environment variables choose the log
+ * like --log-level and --log-categories do; options given on the command line win.
+ *
+ * Parameters:
+ *   argc - Argument count passed to main.
+ *   argv - Argument vector passed to main.
+ *   options - Output parameter receiving the parsed options.
+ *
+ * Returns:
+ *   int - 1 if the options were valid, 0 otherwise.
+ */
+int parseBatchOptions(int argc, char *argv[], BatchOptionsType *options) {
+    if (!options) {
+        fprintf(stderr, "Error: Null options provided to parseBatchOptions.\n");
+        return 0;
+    }
+
+    options->games = 1;
+    options->logCategories = logCategoriesFromEnv(0);
+    options->logChosen = getenv("FP_LOG_LEVEL") != NULL || getenv("FP_LOG_CATEGORIES") != NULL;
+    options->engine = ENGINE_THREADED;
+    options->seed = (unsigned int)time(NULL) ^ (unsigned int)getpid();
+    options->workers = 1;
+    options->shards = 1;
+    options->bench = C_FALSE;
+    options->lanes = SOA_LANES;
+    options->trace = NULL;
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        snprintf(options->names[i], MAX_STR, "Hunter%d", i + 1);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            char *end;
+            options->games = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || options->games <= 0) {
+                fprintf(stderr, "Error: Invalid game count '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--names") == 0 && i + 1 < argc) {
+            const char *names = argv[++i];
+            if (strcmp(names, "auto") == 0) {
+                continue;
+            }
+
+            // Comma separated list with exactly one name per hunter
+            int count = 0;
+            const char *start = names;
+            while (count < NUM_HUNTERS) {
+                size_t length = strcspn(start, ",");
+                if (length == 0 || length >= MAX_STR) {
+                    break;
+                }
+                memcpy(options->names[count], start, length);
+                options->names[count][length] = '\0';
+                count++;
+                start += length;
+                // The last name takes no separator, so a trailing comma is left over and rejected
+                if (count == NUM_HUNTERS || *start != ',') {
+                    break;
+                }
+                start++;
+            }
+            if (count != NUM_HUNTERS || *start != '\0') {
+                fprintf(stderr, "Error: Expected %d comma separated hunter names.\n", NUM_HUNTERS);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--log") == 0) {
+            options->logCategories = LOG_CAT_ALL;
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            options->logChosen = C_TRUE;
+            if (!parseLogLevel(argv[++i], &options->logCategories)) {
+                fprintf(stderr, "Error: Unknown log level '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--log-categories") == 0 && i + 1 < argc) {
+            options->logChosen = C_TRUE;
+            if (!parseLogCategories(argv[++i], &options->logCategories)) {
+                fprintf(stderr, "Error: Unknown log categories '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            const char *engine = argv[++i];
+            if (strcmp(engine, "threaded") == 0) {
+                options->engine = ENGINE_THREADED;
+            } else if (strcmp(engine, "tick") == 0) {
+                options->engine = ENGINE_TICK;
+            } else if (strcmp(engine, "event") == 0) {
+                options->engine = ENGINE_EVENT;
+            } else if (strcmp(engine, "inline") == 0) {
+                options->engine = ENGINE_INLINE;
+            } else if (strcmp(engine, "soa") == 0) {
+                options->engine = ENGINE_SOA;
+            } else {
+                fprintf(stderr, "Error: Unknown engine '%s'.\n", engine);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            char *end;
+            options->seed = (unsigned int)strtoul(argv[++i], &end, 10);
+            if (*end != '\0') {
+                fprintf(stderr, "Error: Invalid seed '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--lanes") == 0 && i + 1 < argc) {
+            char *end;
+            options->lanes = (int)strtol(argv[++i], &end, 10);
+            if (*end != '\0' || options->lanes <= 0 || options->lanes > SOA_LANES) {
+                fprintf(stderr, "Error: Invalid lane count '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            char *end;
+            if (strcmp(argv[++i], "auto") == 0) {
+                options->workers = defaultWorkerCount();
+                continue;
+            }
+            options->workers = (int)strtol(argv[i], &end, 10);
+            if (*end != '\0' || options->workers <= 0) {
+                fprintf(stderr, "Error: Invalid worker count '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            char *end;
+            options->shards = (int)strtol(argv[++i], &end, 10);
+            if (*end != '\0' || options->shards <= 0) {
+                fprintf(stderr, "Error: Invalid shard count '%s'.\n", argv[i]);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options->trace = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            if (strcmp(argv[++i], "rng") != 0) {
+                fprintf(stderr, "Error: Unknown benchmark '%s'.\n", argv[i]);
+                return 0;
+            }
+            options->bench = C_TRUE;
+        } else {
+            fprintf(stderr, "Error: Unknown or incomplete option '%s'.\n", argv[i]);
+            return 0;
+        }
+    }
+
+    if (options->shards > 1 && options->workers > 1) {
+        fprintf(stderr, "Error: --shards and --workers cannot be combined.\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Prints the command line usage to stderr.
+ *
+ * Parameters:
+ *   program - The program name, as given in argv[0].
+ */
+void printUsage(const char *program) {
+    fprintf(stderr, "Usage: %s                       play one interactive game\n", program);
+    fprintf(stderr, "       %s --games N [--names auto|a,b,c,d] [--log] [--engine threaded|tick|event|inline|soa] [--seed S]\n", program);
+    fprintf(stderr, "          [--workers N|auto | --shards K] [--lanes N] [--trace FILE]\n");
+    fprintf(stderr, "          [--log-level off|info|debug] [--log-categories init,hunter-move,ghost-move,hunter-evidence,ghost-evidence,review,exit]\n");
+    fprintf(stderr, "       %s --bench rng [--seed S]     time the random generators\n", program);
+}
+
+/**
+ * Plays the requested number of games back to back, printing one compact
+ * CSV record per game to stdout and a summary of all games to stderr.
+ *
+ * Parameters:
+ *   options - Pointer to the parsed batch options.
+ *
+ * Returns:
+ *   int - 1 if every game was played, 0 if a shard failed.
+ */
+int runBatch(BatchOptionsType *options) {
+    GameStatsType stats = {0};
+
+    setLogCategories(options->logCategories);
+    if (options->trace) {
+        if (!openTrace(options->trace)) {
+            return 0;
+        }
+        // A trace keeps the whole log unless a level or categories were chosen, even off
+        if (!options->logChosen) {
+            setLogCategories(LOG_CAT_ALL);
+        }
+    }
+
+    fputs(GAME_CSV_HEADER, stdout);
+    if (options->shards <= 1) {
+        startLogWriter(); // shards start their own after the fork
+    }
+    int failed = 0;
+    if (options->shards > 1) {
+        failed = runGameShards(options, &stats);
+    } else if (options->workers > 1) {
+        runGamePool(options, &stats);
+    } else {
+        playGameRange(options, 0, options->games, &stats);
+    }
+    stopLogWriter();
+    closeTrace();
+    fflush(stdout);
+
+    printGameStats(&stats);
+    return failed == 0;
+}
+
+/**
+ * Plays a range of consecutive games on the calling thread, printing each
+ * game's record and adding it to the statistics.
+ *
+ * Parameters:
+ *   options - Pointer to the parsed batch options.
+ *   first - Index of the first game.
+ *   count - Number of games to play.
+ *   stats - Pointer to the statistics receiving every game's result.
+ */
+void playGameRange(BatchOptionsType *options, long first, long count, GameStatsType *stats) {
+    if (options->engine == ENGINE_SOA) {
+        GameLanesType *lanes = createGameLanes(options->lanes);
+        if (!lanes) {
+            exit(EXIT_FAILURE);
+        }
+        playGameLanes(lanes, options, first, count, stats);
+        freeGameLanes(lanes);
+        return;
+    }
+
+    for (long game = first; game < first + count; game++) {
+        GameResultType result;
+        playGame(options, game, &result);
+        printGameRecord(game, &result);
+        addGameResult(stats, &result);
+    }
+}
+
+/**
+ * Plays one complete game without any user interaction.
+ *
+ * Parameters:
+ *   options - Pointer to the batch options providing the hunter names.
+ *   game - Zero based index of the game within the batch.
+ *   result - Output parameter receiving the game's summary.
+ */
+void playGame(BatchOptionsType *options, long game, GameResultType *result) {
+    HouseType house;
+    setupHouse(&house, options->seed, game);
+
+    GhostType *ghost = prepareGhost(&house);
+
+    initializeHunters(&house, options->names);
+
+    assignRandomEquipment(house.hunterArray, house.hunterArray->size, &house.rng);
+    logHunterInitialization(house.hunterArray);
+
+    SharedGameState gameState = {0};
+
+    switch (options->engine) {
+        case ENGINE_TICK:
+            runGameTicked(&house, ghost, &gameState);
+            break;
+        case ENGINE_EVENT:
+            runGameEvents(&house, ghost, &gameState);
+            break;
+        case ENGINE_INLINE:
+            runGameInline(&house, ghost);
+            break;
+        default: {
+            pthread_t ghostThread, hunterThreads[NUM_HUNTERS];
+            setupThreads(&ghostThread, hunterThreads, &gameState, ghost, &house);
+
+            waitForThreadsCompletion(ghostThread, hunterThreads);
+            break;
+        }
+    }
+
+    tallyGameOutcome(&house, ghost, result);
+
+    freeHouse(&house);
+}
+
+/**
+ * Prints a single game's summary as one CSV line. While the log writer runs the
+ * line is queued behind the game's log lines instead.
+ *
+ * Parameters:
+ *   game - Zero based index of the game within the batch.
+ *   result - Pointer to the game's summary.
+ */
+void printGameRecord(long game, const GameResultType *result) {
+    if (l_gameRecord(game, result)) {
+        return;
+    }
+
+    char line[LOG_LINE_MAX];
+    formatGameRecord(line, game, result);
+    fputs(line, stdout);
+}
+
+/**
+ * Adds one game's summary to the running batch statistics.
+ *
+ * Parameters:
+ *   stats - Pointer to the statistics to update.
+ *   result - Pointer to the game's summary.
+ */
+void addGameResult(GameStatsType *stats, const GameResultType *result) {
+    stats->games++;
+    stats->outcomes[result->outcome]++;
+    if (result->identified != GH_UNKNOWN && result->identified == result->ghostType) {
+        stats->identified++;
+    }
+}
+
+/**
+ * Adds one set of batch statistics to another.
+ *
+ * Parameters:
+ *   into - Pointer to the statistics to update.
+ *   from - Pointer to the statistics to add.
+ */
+void mergeGameStats(GameStatsType *into, const GameStatsType *from) {
+    into->games += from->games;
+    for (int i = 0; i < OUTCOME_COUNT; i++) {
+        into->outcomes[i] += from->outcomes[i];
+    }
+    into->identified += from->identified;
+}
+
+/**
+ * Prints the aggregated batch statistics to stderr.
+ *
+ * Parameters:
+ *   stats - Pointer to the statistics to print.
+ */
+void printGameStats(const GameStatsType *stats) {
+    fprintf(stderr, "games=%ld ghost_wins=%ld hunter_wins=%ld ghost_left=%ld identified=%ld\n",
+            stats->games, stats->outcomes[OUTCOME_GHOST_WINS], stats->outcomes[OUTCOME_HUNTERS_WIN],
+            stats->outcomes[OUTCOME_GHOST_LEFT], stats->identified);
+}
@@ -0,0 +1,110 @@
+#include "defs.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC   1
+#else
+#define BENCH_HAS_TSC   0
+#endif
+
+/*
+    Returns the current time in nanoseconds from the monotonic clock.
+*/
+static long long benchNanos() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+    Returns the time-stamp counter, or 0 where there is none.
+*/
+static unsigned long long benchTicks() {
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*
+    Prints one benchmark line: the cost of a draw in nanoseconds and in time-stamp counter
+    cycles (x86 only).
+        in:   name - the name of the measured generator
+        in:   draws - the number of draws measured
+        in:   nanos - the elapsed nanoseconds
+        in:   ticks - the elapsed time-stamp counter cycles
+*/
+static void printBenchLine(const char *name, long draws, long long nanos, unsigned long long ticks) {
+    if (BENCH_HAS_TSC) {
+        printf("%s,%.2f,%.2f\n", name, (double)nanos / draws, (double)ticks / draws);
+    } else {
+        printf("%s,%.2f,\n", name, (double)nanos / draws);
+    }
+}
+
+/**
+ * Times the random generators on the calling thread and prints the cost of
+ * one draw of each: raw 32 bit words from a stream, integers from rngInt,
+ * integers the old way through a float, and words from the bulk philoxFill.
+ *
+ * Parameters:
+ *   options - Pointer to the batch options providing the seed.
+ */
+void runRngBenchmark(BatchOptionsType *options) {
+    static unsigned int counters[RNG_BENCH_BATCH][RNG_BLOCK_WORDS];
+    static unsigned int words[RNG_BENCH_BATCH][RNG_BLOCK_WORDS];
+    const long draws = RNG_BENCH_DRAWS;
+    unsigned int sink = 0;
+    RngType rng;
+
+    printf("generator,ns_per_draw,cycles_per_draw\n");
+
+    rngInit(&rng, options->seed, 0, RNG_STREAM_GHOST);
+    long long nanos = benchNanos();
+    unsigned long long ticks = benchTicks();
+    for (long i = 0; i < draws; i++) {
+        sink ^= rngNext(&rng);
+    }
+    printBenchLine("rngNext", draws, benchNanos() - nanos, benchTicks() - ticks);
+
+    rngInit(&rng, options->seed, 0, RNG_STREAM_GHOST);
+    nanos = benchNanos();
+    ticks = benchTicks();
+    for (long i = 0; i < draws; i++) {
+        sink += (unsigned int)rngInt(&rng, 0, 3);
+    }
+    printBenchLine("rngInt", draws, benchNanos() - nanos, benchTicks() - ticks);
+
+    // The float round-trip randInt used to take
+    rngInit(&rng, options->seed, 0, RNG_STREAM_GHOST);
+    nanos = benchNanos();
+    ticks = benchTicks();
+    for (long i = 0; i < draws; i++) {
+        sink += (unsigned int)(int)rngFloat(&rng, 0, 3);
+    }
+    printBenchLine("rngFloat_cast", draws, benchNanos() - nanos, benchTicks() - ticks);
+
+    unsigned int key[2];
+    rngKey(options->seed, key);
+    for (int i = 0; i < RNG_BENCH_BATCH; i++) {
+        counters[i][1] = RNG_STREAM_GHOST;
+        counters[i][2] = (unsigned int)i;
+        counters[i][3] = 0;
+    }
+    long blocks = 0;
+    nanos = benchNanos();
+    ticks = benchTicks();
+    for (unsigned int block = 0; blocks * RNG_BLOCK_WORDS < draws; block++, blocks += RNG_BENCH_BATCH) {
+        for (int i = 0; i < RNG_BENCH_BATCH; i++) {
+            counters[i][0] = block;
+        }
+        philoxFill(key, (const unsigned int (*)[RNG_BLOCK_WORDS])counters, words, RNG_BENCH_BATCH);
+        sink ^= words[block % RNG_BENCH_BATCH][0];
+    }
+    printBenchLine("philoxFill", blocks * RNG_BLOCK_WORDS, benchNanos() - nanos, benchTicks() - ticks);
+
+    // Keeps the draws from being optimized away
+    fflush(stdout);
+    fprintf(stderr, "checksum=%08x\n", sink);
+}
@@ -0,0 +1,999 @@
+// The arena's block pool is private to arena.c, so the checks build it in, and
+// defs.h with it, to reach the pool
+#include "arena.c"
+
+#define RNG_CHECK_DRAWS     700000              // rngInt draws tallied for the uniformity check
+#define EVENT_CHECK_ROUNDS  1000                // seeded queues filled and emptied by the event queue check
+#define EVIDENCE_CHECK_DROPS 64                 // evidence left by the ghost in the room evidence check
+#define EVIDENCE_CHECK_SETS 1000                // shared evidence sets raced for by the evidence set check
+#define OCCUPANCY_CHECK_MOVES 100000            // round trips each hunter makes in the occupancy check
+#define ARENA_CHECK_ALLOCS  2000                // allocations made by the arena check, enough to span several blocks
+#define POOL_CHECK_ROUNDS   100000              // pops and pushes each thread makes in the pool check
+#define NAME_CHECK_NAMES    40                  // names interned by each round of the name table check
+#define LOG_CHECK_THREADS   8                   // threads logging at once in the log writer check
+#define LOG_CHECK_LINES     5000                // lines each of them logs, several rings' worth
+#define MERGE_CHECK_THREADS 4                   // threads taking turns to log in the merge order check
+#define MERGE_CHECK_TURNS   20000               // turns they take between them
+#define TRACE_CHECK_MOVES   100                 // ghost moves traced before and after fp-trace --follow starts
+
+// Checks run by make check. Each prints a line for every failed expectation;
+// the program fails if any did.
+
+static int failures = 0;
+
+/**
+ * Records one expectation, printing it if it does not hold.
+ *
+ * Parameters:
+ *   ok - Whether the expectation holds.
+ *   what - What was expected, for the failure line.
+ */
+static void expect(int ok, const char *what) {
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+/**
+ * Checks Philox4x32-10 against the known answers published with Random123.
+ */
+static void checkPhilox() {
+    static const struct {
+        unsigned int key[2];
+        unsigned int counter[4];
+        unsigned int expected[4];
+    } answers[] = {
+        { { 0x00000000, 0x00000000 }, { 0x00000000, 0x00000000, 0x00000000, 0x00000000 },
+          { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+        { { 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+          { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+        { { 0xa4093822, 0x299f31d0 }, { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 },
+          { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+    };
+
+    for (size_t i = 0; i < sizeof(answers) / sizeof(answers[0]); i++) {
+        unsigned int out[1][4];
+        philoxFill(answers[i].key, &answers[i].counter, out, 1);
+        expect(memcmp(out[0], answers[i].expected, sizeof(out[0])) == 0, "philoxFill matches the Random123 known answer");
+    }
+
+    // A stream draws the words of its blocks in order, block 0 first
+    RngType rng;
+    unsigned int counters[2][4] = { { 0, RNG_STREAM_GHOST, 7, 0 }, { 1, RNG_STREAM_GHOST, 7, 0 } };
+    unsigned int blocks[2][4];
+    rngInit(&rng, 5, 7, RNG_STREAM_GHOST);
+    philoxFill(rng.key, counters, blocks, 2);
+    for (int word = 0; word < 8; word++) {
+        expect(rngNext(&rng) == blocks[word / 4][word % 4], "rngNext draws the stream's blocks in order");
+    }
+}
+
+/**
+ * Loads the next words a stream will draw, so a check can pick them.
+ *
+ * Parameters:
+ *   rng - The stream.
+ *   words - The four words of its current block.
+ */
+static void loadWords(RngType *rng, const unsigned int words[RNG_BLOCK_WORDS]) {
+    memcpy(rng->block, words, sizeof(rng->block));
+    rng->used = 0;
+}
+
+/**
+ * Checks that rngInt maps words onto its range with Lemire's multiply-shift,
+ * redraws the words that would bias it, and stays inside [min, max).
+ */
+static void checkRngInt() {
+    RngType rng;
+    rngInit(&rng, 5, 0, RNG_STREAM_SETUP);
+
+    loadWords(&rng, (const unsigned int[]){ 0xFFFFFFFFu, 0xFFFFFFFFu, 0, 0 });
+    expect(rngInt(&rng, 0, 7) == 6, "rngInt maps the largest word to max - 1");
+    expect(rngInt(&rng, -5, 5) == 4, "rngInt offsets a negative range");
+
+    // For a range of 3 the single word below the threshold, 0, is redrawn
+    loadWords(&rng, (const unsigned int[]){ 0, 0x80000000u, 0, 0 });
+    expect(rngInt(&rng, 0, 3) == 1, "rngInt redraws the word that biases a range of 3");
+    expect(rngInt(&rng, 0, 4) == 0, "rngInt keeps word 0 for a power of two range");
+
+    int counts[7] = { 0 };
+    int inRange = 1;
+    for (int i = 0; i < RNG_CHECK_DRAWS; i++) {
+        int value = rngInt(&rng, -3, 4);
+        if (value < -3 || value >= 4) {
+            inRange = 0;
+            break;
+        }
+        counts[value + 3]++;
+    }
+    expect(inRange, "rngInt stays inside [min, max)");
+    for (int i = 0; i < 7; i++) {
+        expect(abs(counts[i] - RNG_CHECK_DRAWS / 7) < RNG_CHECK_DRAWS / 70, "rngInt draws every value about equally often");
+    }
+}
+
+/**
+ * Checks that the event queue pops events by time, and that events due at the
+ * same time come out ghost first, then hunters by index.
+ */
+static void checkEventQueue() {
+    EventQueueType queue;
+    GameEventType event;
+    initEventQueue(&queue);
+
+    pushEvent(&queue, 10, 2);
+    pushEvent(&queue, 10, 0);
+    pushEvent(&queue, 20, EVENT_GHOST);
+    pushEvent(&queue, 10, EVENT_GHOST);
+    pushEvent(&queue, 10, 1);
+    static const GameEventType order[] = { { 10, EVENT_GHOST }, { 10, 0 }, { 10, 1 }, { 10, 2 }, { 20, EVENT_GHOST } };
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        expect(popEvent(&queue, &event) && event.time == order[i].time && event.entity == order[i].entity,
+               "popEvent runs tied events ghost first, then hunters by index");
+    }
+    expect(!popEvent(&queue, &event), "popEvent reports an empty queue");
+
+    // Full queues of seeded events come out sorted
+    RngType rng;
+    rngInit(&rng, 5, 0, RNG_STREAM_SETUP);
+    int complete = 1, sorted = 1;
+    for (int round = 0; round < EVENT_CHECK_ROUNDS; round++) {
+        for (int i = 0; i < MAX_EVENTS; i++) {
+            pushEvent(&queue, rngInt(&rng, 0, 4) * GHOST_WAIT, rngInt(&rng, EVENT_GHOST, NUM_HUNTERS));
+        }
+        GameEventType previous = { -1, EVENT_GHOST };
+        int popped = 0;
+        while (popEvent(&queue, &event)) {
+            sorted = sorted && !isEventBefore(&event, &previous);
+            previous = event;
+            popped++;
+        }
+        complete = complete && popped == MAX_EVENTS;
+    }
+    expect(sorted, "popEvent returns events in (time, entity) order");
+    expect(complete, "popEvent returns every pushed event");
+}
+
+/**
+ * Checks that a room keeps one evidence bit per type: each piece the ghost
+ * leaves sets its type's bit, leaving a type again changes nothing, and
+ * doesEvidenceExist finds exactly the types left.
+ */
+static void checkRoomEvidence() {
+    RoomType room = { .nameId = 0 };
+    GhostType ghost = { .room = &room, .ghostType = BANSHEE };
+    atomic_init(&room.evidence, 0);
+    rngInit(&ghost.rng, 5, 0, RNG_STREAM_GHOST);
+
+    unsigned int left = 0;
+    int onlyNewBits = 1;
+    for (int i = 0; i < EVIDENCE_CHECK_DROPS; i++) {
+        EvidenceType evidence = addEv(&ghost);
+        left |= EVIDENCE_BIT(evidence);
+        onlyNewBits = onlyNewBits && atomic_load(&room.evidence) == left;
+    }
+    expect(onlyNewBits, "addEv sets only the bit of the evidence it leaves");
+    expect(left == (EVIDENCE_BIT(EMF) | EVIDENCE_BIT(TEMPERATURE) | EVIDENCE_BIT(SOUND)),
+           "a banshee leaves EMF, temperature and sound");
+
+    for (int type = EMF; type < EV_COUNT; type++) {
+        EvidenceType found = doesEvidenceExist(&room, (EvidenceType)type);
+        expect(found == ((left & EVIDENCE_BIT(type)) ? (EvidenceType)type : EV_UNKNOWN),
+               "doesEvidenceExist finds exactly the evidence left in the room");
+    }
+    expect(doesEvidenceExist(&room, EV_UNKNOWN) == EV_UNKNOWN, "doesEvidenceExist finds nothing for unknown equipment");
+}
+
+static EvidenceArrayType evidenceSets[EVIDENCE_CHECK_SETS];
+
+/**
+ * Collects every evidence type into each shared set, starting from a different
+ * type per thread so the threads race for the last free place.
+ *
+ * Parameters:
+ *   arg - The thread's index, cast to a pointer.
+ *
+ * Returns:
+ *   void* - The number of pieces this thread added, cast to a pointer.
+ */
+static void *collectEvidenceSets(void *arg) {
+    long first = (long)arg, added = 0;
+    for (int set = 0; set < EVIDENCE_CHECK_SETS; set++) {
+        for (int i = 0; i < EV_COUNT; i++) {
+            added += collectEv(&evidenceSets[set], (EvidenceType)((first + i) % EV_COUNT)) == 1;
+        }
+    }
+    return (void *)added;
+}
+
+/**
+ * Checks that collectEv adds a new type, refuses a duplicate or a full set, and
+ * that hunters racing on one set never get more than its capacity in.
+ */
+static void checkEvidenceSet() {
+    EvidenceArrayType evidence;
+    initEvidenceArray(&evidence, MAX_EV);
+    expect(collectEv(&evidence, SOUND) == 1 && countEvidence(&evidence) == 1, "collectEv adds a new type");
+    expect(collectEv(&evidence, SOUND) == -1 && countEvidence(&evidence) == 1, "collectEv refuses a duplicate");
+    expect(collectEv(&evidence, EMF) == 1 && collectEv(&evidence, FINGERPRINTS) == 1, "collectEv fills the set");
+    expect(collectEv(&evidence, TEMPERATURE) == -1 && countEvidence(&evidence) == MAX_EV, "collectEv refuses a full set");
+    expect(identifyGhostFromMask(atomic_load(&evidence.mask)) == BULLIES, "sound, EMF and fingerprints identify bullies");
+
+    pthread_t threads[NUM_HUNTERS];
+    long added = 0;
+    for (int set = 0; set < EVIDENCE_CHECK_SETS; set++) {
+        initEvidenceArray(&evidenceSets[set], MAX_EV);
+    }
+    for (long i = 0; i < NUM_HUNTERS; i++) {
+        pthread_create(&threads[i], NULL, collectEvidenceSets, (void *)i);
+    }
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        void *result;
+        pthread_join(threads[i], &result);
+        added += (long)result;
+    }
+    int full = 1;
+    for (int set = 0; set < EVIDENCE_CHECK_SETS; set++) {
+        full = full && countEvidence(&evidenceSets[set]) == MAX_EV;
+    }
+    expect(full && added == (long)MAX_EV * EVIDENCE_CHECK_SETS, "racing hunters add exactly a set's capacity");
+}
+
+static RoomType occupancyRooms[2];
+
+/**
+ * Moves one hunter back and forth between the two occupancy rooms, ending in
+ * the second.
+ *
+ * Parameters:
+ *   arg - The hunter.
+ *
+ * Returns:
+ *   void* - NULL.
+ */
+static void *moveHunterBetweenRooms(void *arg) {
+    HunterType *hunter = arg;
+    for (int i = 0; i < OCCUPANCY_CHECK_MOVES; i++) {
+        updateHunterLocation(hunter, &occupancyRooms[1]);
+        updateHunterLocation(hunter, &occupancyRooms[0]);
+    }
+    updateHunterLocation(hunter, &occupancyRooms[1]);
+    return NULL;
+}
+
+/**
+ * Checks that a room's occupancy bitset follows its hunters: moving a hunter
+ * moves only its bit, the ghost sees a hunter only in an occupied room, and
+ * hunters moving at the same time never lose each other's bits.
+ */
+static void checkRoomOccupancy() {
+    HunterType hunters[NUM_HUNTERS];
+    HunterArrayType list = { .hunter = hunters, .size = NUM_HUNTERS, .capacity = NUM_HUNTERS };
+    GhostType ghost = { .room = &occupancyRooms[1] };
+    atomic_init(&occupancyRooms[0].hunters, 0);
+    atomic_init(&occupancyRooms[1].hunters, 0);
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        hunters[i] = (HunterType){ .index = i, .room = &occupancyRooms[0] };
+        atomic_fetch_or(&occupancyRooms[0].hunters, HUNTER_BIT(i));
+    }
+
+    expect(!isHunterPresent(&ghost, &list, NUM_HUNTERS), "the ghost sees no hunter in an empty room");
+    updateHunterLocation(&hunters[2], &occupancyRooms[1]);
+    expect(atomic_load(&occupancyRooms[1].hunters) == HUNTER_BIT(2) &&
+           atomic_load(&occupancyRooms[0].hunters) == ((HUNTER_BIT(NUM_HUNTERS) - 1) & ~HUNTER_BIT(2)),
+           "updateHunterLocation moves only the hunter's bit");
+    expect(isHunterPresent(&ghost, &list, NUM_HUNTERS), "the ghost sees a hunter in an occupied room");
+    updateHunterLocation(&hunters[2], &occupancyRooms[0]);
+    expect(!isHunterPresent(&ghost, &list, NUM_HUNTERS), "the ghost sees no hunter once it left");
+
+    pthread_t threads[NUM_HUNTERS];
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        pthread_create(&threads[i], NULL, moveHunterBetweenRooms, &hunters[i]);
+    }
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    expect(atomic_load(&occupancyRooms[0].hunters) == 0 && atomic_load(&occupancyRooms[1].hunters) == HUNTER_BIT(NUM_HUNTERS) - 1,
+           "hunters moving at the same time keep every occupancy bit");
+}
+
+/**
+ * Checks that arena allocations are aligned and never overlap, across block
+ * boundaries and for requests larger than a block, and that a released arena's
+ * block is handed to the next arena of the same thread.
+ */
+static void checkArena() {
+    ArenaType arena;
+    unsigned char *pieces[ARENA_CHECK_ALLOCS];
+    initArena(&arena);
+
+    int aligned = 1;
+    for (int i = 0; i < ARENA_CHECK_ALLOCS; i++) {
+        size_t size = i == ARENA_CHECK_ALLOCS / 2 ? 2 * ARENA_BLOCK_SIZE : (size_t)(i % 97) + 1;
+        pieces[i] = arenaAlloc(&arena, size);
+        aligned = aligned && (size_t)pieces[i] % ARENA_ALIGN == 0;
+        memset(pieces[i], i & 0xFF, size);
+    }
+    int intact = 1;
+    for (int i = 0; i < ARENA_CHECK_ALLOCS; i++) {
+        size_t size = i == ARENA_CHECK_ALLOCS / 2 ? 2 * ARENA_BLOCK_SIZE : (size_t)(i % 97) + 1;
+        for (size_t j = 0; j < size; j++) {
+            intact = intact && pieces[i][j] == (i & 0xFF);
+        }
+    }
+    expect(aligned, "arenaAlloc aligns every allocation to ARENA_ALIGN");
+    expect(intact, "arena allocations never overlap");
+    freeArena(&arena);
+    expect(arena.blocks == NULL, "freeArena leaves the arena empty");
+
+    releaseArenaCache();
+    void *first = arenaAlloc(&arena, 1);
+    freeArena(&arena);
+    expect(arenaAlloc(&arena, 1) == first, "a released block is reused by the next arena");
+    freeArena(&arena);
+    releaseArenaCache();
+}
+
+/**
+ * Counts the blocks on the shared pool, taking them all off.
+ *
+ * Parameters:
+ *   blocks - Where the popped blocks go, at least ARENA_POOL_BLOCKS of them.
+ *
+ * Returns:
+ *   int - The number of blocks popped.
+ */
+static int drainPool(ArenaBlockType **blocks) {
+    int count = 0;
+    while (count < ARENA_POOL_BLOCKS && (blocks[count] = poolPop()) != NULL) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Pops blocks off the shared pool and pushes them back, marking each one while
+ * it holds it so two threads holding the same block would show.
+ *
+ * Parameters:
+ *   arg - The thread's mark, cast to a pointer.
+ *
+ * Returns:
+ *   void* - Non-NULL if another thread held a block at the same time.
+ */
+static void *churnPool(void *arg) {
+    long mark = (long)arg, shared = 0;
+    for (int i = 0; i < POOL_CHECK_ROUNDS; i++) {
+        ArenaBlockType *block = poolPop();
+        if (!block) {
+            continue;
+        }
+        volatile long *held = (volatile long *)(void *)block->data;
+        *held = mark;
+        sched_yield();
+        shared |= *held != mark;
+        poolPush(block);
+    }
+    return (void *)shared;
+}
+
+/**
+ * Checks the process-wide block pool: blocks a thread's cache has no room for
+ * go on the pool and come back off it, the change count in the pool's head wraps
+ * without losing the stack, and threads popping and pushing at the same time
+ * never hold the same block or lose one.
+ */
+static void checkArenaPool() {
+    ArenaType arena;
+    ArenaBlockType *blocks[ARENA_POOL_BLOCKS], *spare[ARENA_POOL_BLOCKS];
+    initArena(&arena);
+    releaseArenaCache();
+    int spares = drainPool(spare);
+
+    // The oldest blocks are released last, once the cache is full
+    void *oldest[2];
+    for (int i = 0; i < ARENA_CACHE_BLOCKS + 2; i++) {
+        void *memory = arenaAlloc(&arena, ARENA_BLOCK_SIZE);
+        if (i < 2) {
+            oldest[i] = memory;
+        }
+    }
+    freeArena(&arena);
+    int count = drainPool(blocks);
+    expect(count == 2 && (void *)blocks[0]->data == oldest[0] && (void *)blocks[1]->data == oldest[1],
+           "blocks past the thread's cache go on the pool");
+    for (int i = 0; i < spares; i++) {
+        blocks[count++] = spare[i];
+    }
+
+    // Push with the change count about to wrap, then pop everything back
+    atomic_store(&poolHead, 0xFFFFFFFFULL << 32);
+    for (int i = count - 1; i >= 0; i--) {
+        poolPush(blocks[i]);
+    }
+    expect(atomic_load(&poolHead) >> 32 == (unsigned long long)count - 1, "the pool's change count wraps around");
+    ArenaBlockType *popped[ARENA_POOL_BLOCKS];
+    expect(drainPool(popped) == count && memcmp(popped, blocks, count * sizeof(blocks[0])) == 0,
+           "the pool keeps its order across the wrap");
+    for (int i = count - 1; i >= 0; i--) {
+        poolPush(blocks[i]);
+    }
+
+    pthread_t threads[NUM_HUNTERS];
+    long shared = 0;
+    for (long i = 0; i < NUM_HUNTERS; i++) {
+        pthread_create(&threads[i], NULL, churnPool, (void *)(i + 1));
+    }
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        void *result;
+        pthread_join(threads[i], &result);
+        shared |= (long)result;
+    }
+    expect(!shared, "no two threads hold the same pooled block");
+    expect(drainPool(popped) == count, "threads churning the pool lose no block");
+    for (int i = 0; i < count; i++) {
+        poolPush(popped[i]);
+    }
+    releaseArenaCache();
+}
+
+/**
+ * Checks the hunter layout: arenaAllocAligned honours its boundary, and every
+ * hunter of a house's array starts on a cache line of its own.
+ */
+static void checkHunterLayout() {
+    ArenaType arena;
+    initArena(&arena);
+    int aligned = 1;
+    for (size_t alignment = 1; alignment <= 2 * CACHE_LINE; alignment *= 2) {
+        arenaAlloc(&arena, 1);
+        aligned = aligned && (uintptr_t)arenaAllocAligned(&arena, 1, alignment) % alignment == 0;
+    }
+    expect(aligned, "arenaAllocAligned returns memory on the boundary asked for");
+
+    HunterArrayType hunters;
+    initHunterArray(&arena, &hunters, NUM_HUNTERS);
+    int ownLines = sizeof(HunterType) % CACHE_LINE == 0;
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        ownLines = ownLines && (uintptr_t)&hunters.hunter[i] % CACHE_LINE == 0;
+    }
+    expect(ownLines, "each hunter's hot block starts on its own cache line");
+    freeArena(&arena);
+    releaseArenaCache();
+}
+
+/**
+ * Identifies a ghost from an evidence mask the way the game did before the
+ * tables were generated, as the reference for the tables.
+ *
+ * Parameters:
+ *   mask - EVIDENCE_BIT of every collected type.
+ *
+ * Returns:
+ *   GhostClass - The class, or GH_UNKNOWN.
+ */
+static GhostClass referenceGhost(unsigned int mask) {
+    switch (mask) {
+        case EVIDENCE_BIT(EMF) | EVIDENCE_BIT(TEMPERATURE) | EVIDENCE_BIT(FINGERPRINTS): return POLTERGEIST;
+        case EVIDENCE_BIT(EMF) | EVIDENCE_BIT(TEMPERATURE) | EVIDENCE_BIT(SOUND):        return BANSHEE;
+        case EVIDENCE_BIT(EMF) | EVIDENCE_BIT(FINGERPRINTS) | EVIDENCE_BIT(SOUND):       return BULLIES;
+        case EVIDENCE_BIT(TEMPERATURE) | EVIDENCE_BIT(FINGERPRINTS) | EVIDENCE_BIT(SOUND): return PHANTOM;
+        default:                                                                          return GH_UNKNOWN;
+    }
+}
+
+/**
+ * Returns the evidence a ghost left for one draw the way the game did before
+ * the tables were generated, as the reference for the tables.
+ *
+ * Parameters:
+ *   ghostType - The ghost's class.
+ *   choice - The draw, 0 to 2.
+ *
+ * Returns:
+ *   EvidenceType - The evidence left, or EV_UNKNOWN.
+ */
+static EvidenceType referenceEvidence(GhostClass ghostType, int choice) {
+    switch (ghostType) {
+        case POLTERGEIST: return (choice == 0) ? EMF : (choice == 1) ? TEMPERATURE : FINGERPRINTS;
+        case BANSHEE:     return (choice == 0) ? EMF : (choice == 1) ? TEMPERATURE : SOUND;
+        case BULLIES:     return (choice == 0) ? EMF : (choice == 1) ? FINGERPRINTS : SOUND;
+        case PHANTOM:     return (choice == 0) ? TEMPERATURE : (choice == 1) ? FINGERPRINTS : SOUND;
+        default:          return EV_UNKNOWN;
+    }
+}
+
+/**
+ * Checks the tables generated from GHOST_CLASSES against the switches they
+ * replaced: identification for all 16 evidence masks, the evidence of every
+ * class for each draw, and the class names.
+ */
+static void checkGhostTables() {
+    for (unsigned int mask = 0; mask < (1u << EV_COUNT); mask++) {
+        expect(identifyGhostFromMask(mask) == referenceGhost(mask), "ghostByMask identifies every mask as before");
+    }
+
+    static const char *const names[] = { "Poltergeist", "Banshee", "Bullies", "Phantom", "Unknown" };
+    static const unsigned int draws[RNG_BLOCK_WORDS] = { 0x10000000u, 0x60000000u, 0xB0000000u, 0x10000000u };
+    RngType rng;
+    rngInit(&rng, 5, 0, RNG_STREAM_GHOST);
+    for (int ghost = POLTERGEIST; ghost <= GHOST_COUNT; ghost++) {
+        GhostClass ghostType = ghost < GHOST_COUNT ? (GhostClass)ghost : GH_UNKNOWN;
+        char name[MAX_STR];
+        ghostToString(ghostType, name);
+        expect(strcmp(name, names[ghost]) == 0, "ghostToString names every class as before");
+
+        // The three words draw choices 0, 1 and 2
+        loadWords(&rng, draws);
+        for (int choice = 0; choice < 3; choice++) {
+            expect(determineEvidenceType(ghostType, &rng) == referenceEvidence(ghostType, choice),
+                   "ghostEvidence leaves the same evidence per class and draw as before");
+        }
+    }
+}
+
+/**
+ * Interns the same names as every other thread running it, in its own order,
+ * recording the id each one got.
+ *
+ * Parameters:
+ *   arg - The thread's row of NAME_CHECK_NAMES ids, its first element holding
+ *         the thread's index on entry.
+ *
+ * Returns:
+ *   void* - NULL.
+ */
+static void *internNames(void *arg) {
+    int *ids = arg;
+    int first = ids[0];
+    char name[MAX_STR];
+    for (int i = 0; i < NAME_CHECK_NAMES; i++) {
+        int index = (first * 7 + i) % NAME_CHECK_NAMES;
+        snprintf(name, sizeof(name), "Shared name %d", index);
+        ids[index] = internName(name);
+    }
+    return NULL;
+}
+
+/**
+ * Checks the process-wide name table: every name gets one id and keeps it on
+ * repeated interns, threads interning the same names at the same time agree on
+ * their ids, and nameOf gives the text back. Two houses set up the same way
+ * give their rooms the same ids.
+ */
+static void checkNameTable() {
+    char name[MAX_STR];
+    int ids[NAME_CHECK_NAMES];
+    int stable = 1;
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < NAME_CHECK_NAMES; i++) {
+            snprintf(name, sizeof(name), "Room %d", i);
+            int id = internName(name);
+            stable = stable && (round == 0 || id == ids[i]) && strcmp(nameOf(id), name) == 0;
+            ids[i] = id;
+        }
+    }
+    for (int i = 1; i < NAME_CHECK_NAMES; i++) {
+        stable = stable && ids[i] != ids[i - 1];
+    }
+    expect(stable, "internName gives each name one id and keeps it");
+    expect(strcmp(nameOf(-1), "No Room") == 0, "nameOf reports an id the table does not hold");
+
+    pthread_t threads[NUM_HUNTERS];
+    int threadIds[NUM_HUNTERS][NAME_CHECK_NAMES];
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        threadIds[i][0] = i;
+        pthread_create(&threads[i], NULL, internNames, threadIds[i]);
+    }
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    int agreed = 1;
+    for (int i = 0; i < NAME_CHECK_NAMES; i++) {
+        snprintf(name, sizeof(name), "Shared name %d", i);
+        for (int thread = 0; thread < NUM_HUNTERS; thread++) {
+            agreed = agreed && threadIds[thread][i] == threadIds[0][i] && strcmp(nameOf(threadIds[thread][i]), name) == 0;
+        }
+        agreed = agreed && (i == 0 || threadIds[0][i] != threadIds[0][i - 1]);
+    }
+    expect(agreed, "threads interning the same names at once agree on their ids");
+
+    HouseType first, second;
+    initHouse(&first);
+    populateRooms(&first);
+    initHouse(&second);
+    populateRooms(&second);
+    int same = 1;
+    for (RoomNodeType *a = first.rooms->rhead, *b = second.rooms->rhead; a || b; a = a->next, b = b->next) {
+        same = same && a && b && a->room->nameId == b->room->nameId;
+        if (!same) {
+            break;
+        }
+    }
+    expect(same, "houses set up the same way give their rooms the same ids");
+    freeHouse(&first);
+    freeHouse(&second);
+    releaseArenaCache();
+}
+
+/**
+ * Sends stdout to a temporary file, so a check can read back what the log
+ * writer printed.
+ *
+ * Parameters:
+ *   saved - Receives a copy of the real stdout, for restoreStdout.
+ *
+ * Returns:
+ *   FILE* - The file now taking stdout, or NULL if it could not be redirected.
+ */
+static FILE *captureStdout(int *saved) {
+    FILE *capture = tmpfile();
+    fflush(stdout);
+    *saved = dup(STDOUT_FILENO);
+    if (!capture || *saved < 0 || dup2(fileno(capture), STDOUT_FILENO) < 0) {
+        fprintf(stderr, "Error: Cannot capture stdout.\n");
+        exit(EXIT_FAILURE);
+    }
+    return capture;
+}
+
+/**
+ * Puts the real stdout back and rewinds the capture for reading.
+ *
+ * Parameters:
+ *   capture - The file returned by captureStdout.
+ *   saved - The copy of the real stdout.
+ */
+static void restoreStdout(FILE *capture, int saved) {
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    rewind(capture);
+}
+
+/**
+ * Logs LOG_CHECK_LINES evidence counts numbered from 0, with the thread's index
+ * in place of the evidence type.
+ *
+ * Parameters:
+ *   arg - The thread's index, cast to a pointer.
+ *
+ * Returns:
+ *   void* - NULL.
+ */
+static void *logNumberedLines(void *arg) {
+    int thread = (int)(long)arg;
+    for (int i = 0; i < LOG_CHECK_LINES; i++) {
+        l_evidenceCount((EvidenceType)thread, i);
+    }
+    return NULL;
+}
+
+/**
+ * Checks that lines logged through the rings all reach stdout through the log
+ * writer, whole and in the order each thread logged them, even when the
+ * threads log far more than a ring holds.
+ */
+static void checkLogWriter() {
+    int saved;
+    FILE *capture = captureStdout(&saved);
+    setLogCategories(LOG_CAT_ALL);
+    startLogWriter();
+    pthread_t threads[LOG_CHECK_THREADS];
+    for (long i = 0; i < LOG_CHECK_THREADS; i++) {
+        pthread_create(&threads[i], NULL, logNumberedLines, (void *)i);
+    }
+    for (int i = 0; i < LOG_CHECK_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    stopLogWriter();
+    setLogCategories(0);
+    restoreStdout(capture, saved);
+
+    int next[LOG_CHECK_THREADS] = { 0 };
+    int whole = 1, ordered = 1, thread, count;
+    char line[LOG_LINE_MAX];
+    while (fgets(line, sizeof(line), capture)) {
+        if (sscanf(line, "Collected evidence type %d, total count: %d.", &thread, &count) != 2 ||
+            thread < 0 || thread >= LOG_CHECK_THREADS) {
+            whole = 0;
+            continue;
+        }
+        ordered = ordered && count == next[thread];
+        next[thread] = count + 1;
+    }
+    fclose(capture);
+    for (int i = 0; i < LOG_CHECK_THREADS; i++) {
+        whole = whole && next[i] == LOG_CHECK_LINES;
+    }
+    expect(whole, "the log writer prints every line whole");
+    expect(ordered, "the log writer keeps each thread's lines in order");
+}
+
+// The next turn of the merge order check, each taken by the thread it is a multiple of
+static atomic_int mergeTurn;
+
+/**
+ * Takes every MERGE_CHECK_THREADS'th turn of the merge order check, logging the
+ * turn as an evidence count with the thread's index as the type, then passing
+ * the turn on.
+ *
+ * Parameters:
+ *   arg - The thread's index, cast to a pointer.
+ *
+ * Returns:
+ *   void* - Always NULL.
+ */
+static void *logTurns(void *arg) {
+    int thread = (int)(long)arg;
+    for (;;) {
+        int turn = atomic_load(&mergeTurn);
+        if (turn >= MERGE_CHECK_TURNS) {
+            return NULL;
+        }
+        if (turn % MERGE_CHECK_THREADS != thread) {
+            sched_yield();
+            continue;
+        }
+        l_evidenceCount((EvidenceType)thread, turn);
+        atomic_store(&mergeTurn, turn + 1);
+    }
+}
+
+/**
+ * Checks that the log writer merges the rings in the order the lines were
+ * logged: threads that take turns to log a line each print their lines in
+ * turn order, not just each thread's lines in order.
+ */
+static void checkLogMerge() {
+    int saved;
+    FILE *capture = captureStdout(&saved);
+    setLogCategories(LOG_CAT_ALL);
+    atomic_store(&mergeTurn, 0);
+    startLogWriter();
+    pthread_t threads[MERGE_CHECK_THREADS];
+    for (long i = 0; i < MERGE_CHECK_THREADS; i++) {
+        pthread_create(&threads[i], NULL, logTurns, (void *)i);
+    }
+    for (int i = 0; i < MERGE_CHECK_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    stopLogWriter();
+    setLogCategories(0);
+    restoreStdout(capture, saved);
+
+    int next = 0, ordered = 1, thread, turn;
+    char line[LOG_LINE_MAX];
+    while (fgets(line, sizeof(line), capture)) {
+        ordered = ordered && sscanf(line, "Collected evidence type %d, total count: %d.", &thread, &turn) == 2 &&
+                  turn == next && thread == turn % MERGE_CHECK_THREADS;
+        next++;
+    }
+    fclose(capture);
+    expect(ordered && next == MERGE_CHECK_TURNS, "the log writer merges the threads' lines in the order they were logged");
+}
+
+/**
+ * Checks that every kind of log record survives a trip through the trace
+ * format: the decoded record carries the same stamps and prints the same line.
+ * One packed record is also compared byte for byte, so a change to the trace
+ * layout cannot go unnoticed.
+ */
+static void checkTraceRecords() {
+    int hunter = internName("Hunter1");
+    int room = internName("Hallway");
+    const LogRecordType records[] = {
+        { .kind = LOG_HUNTER_INIT, .detail = FINGERPRINTS, .hunter = hunter, .room = -1 },
+        { .kind = LOG_HUNTER_MOVE, .hunter = hunter, .room = room },
+        { .kind = LOG_HUNTER_REVIEW, .detail = LOG_SUFFICIENT, .hunter = hunter, .room = -1 },
+        { .kind = LOG_HUNTER_COLLECT, .detail = SOUND, .hunter = hunter, .room = room },
+        { .kind = LOG_HUNTER_EXIT, .detail = LOG_BORED, .hunter = hunter, .room = -1 },
+        { .kind = LOG_HUNTER_LEFT, .hunter = hunter, .room = -1 },
+        { .kind = LOG_EVIDENCE_COUNT, .detail = EMF, .hunter = -1, .room = -1, .count = 3 },
+        { .kind = LOG_GHOST_INIT, .detail = PHANTOM, .hunter = -1, .room = room },
+        { .kind = LOG_GHOST_MOVE, .hunter = -1, .room = room },
+        { .kind = LOG_GHOST_EVIDENCE, .detail = TEMPERATURE, .hunter = -1, .room = room },
+        { .kind = LOG_GHOST_EXIT, .detail = LOG_FEAR, .hunter = -1, .room = -1 },
+        { .kind = LOG_GHOST_THREAD, .thread = 0x7f00deadbeefUL },
+        { .kind = LOG_GAME_RECORD, .result = { BANSHEE, GH_UNKNOWN, OUTCOME_GHOST_LEFT, 2, 1, 3, BOREDOM_MAX } },
+    };
+
+    for (size_t i = 0; i < sizeof(records) / sizeof(records[0]); i++) {
+        LogRecordType record = records[i], decoded;
+        TraceRecordType trace;
+        char line[LOG_LINE_MAX], decodedLine[LOG_LINE_MAX];
+        if (record.kind != LOG_GHOST_THREAD) {
+            record.game = 123456789;
+        }
+        // A game record's tick holds its counts instead
+        if (record.kind != LOG_GAME_RECORD) {
+            record.tick = 4321;
+        }
+
+        encodeTraceRecord(&record, &trace);
+        decodeTraceRecord(&trace, &decoded);
+        formatLogRecord(&record, line);
+        formatLogRecord(&decoded, decodedLine);
+        expect(decoded.kind == record.kind && decoded.tick == record.tick && decoded.game == record.game,
+               "a traced record keeps its kind, tick and game");
+        expect(strcmp(line, decodedLine) == 0, "a traced record prints the same log line");
+        expect(record.kind == LOG_GHOST_THREAD || record.kind == LOG_GAME_RECORD ||
+               (decoded.detail == record.detail && decoded.hunter == record.hunter && decoded.room == record.room),
+               "a traced record keeps its detail, hunter and room, or their absence");
+    }
+
+    LogRecordType move = { .kind = LOG_HUNTER_MOVE, .tick = 0x01020304, .game = 0x0A0B0C0D, .hunter = hunter, .room = room };
+    TraceRecordType trace;
+    const uint8_t packed[] = { LOG_HUNTER_MOVE, 0, (uint8_t)hunter, (uint8_t)room, 0x04, 0x03, 0x02, 0x01,
+                               0x0D, 0x0C, 0x0B, 0x0A, 0, 0, 0, 0 };
+    encodeTraceRecord(&move, &trace);
+    expect(sizeof(trace) == sizeof(packed) && memcmp(&trace, packed, sizeof(packed)) == 0,
+           "a traced hunter move packs into the documented 16 bytes");
+    expect(sizeof(TraceHeaderType) % sizeof(TraceRecordType) == 0, "the trace header is whole records");
+    LogRecordType ghostMove = { .kind = LOG_GHOST_MOVE, .hunter = -1, .room = room };
+    encodeTraceRecord(&ghostMove, &trace);
+    expect(trace.hunter == TRACE_NONE, "a traced ghost record names no hunter");
+}
+
+/**
+ * Reads what fp-trace prints, counting its log lines, and waits for it to exit.
+ *
+ * Parameters:
+ *   command - The fp-trace command line it was started with, for the error message.
+ *   decoder - The pipe from fp-trace.
+ *   moves - Output parameter receiving the number of ghost move lines.
+ *
+ * Returns:
+ *   int - 1 if fp-trace printed the CSV header first and exited successfully, 0 otherwise.
+ */
+static int readTraceDecoder(const char *command, FILE *decoder, int *moves) {
+    char line[LOG_LINE_MAX];
+    int header = fgets(line, sizeof(line), decoder) != NULL && strcmp(line, GAME_CSV_HEADER) == 0;
+    *moves = 0;
+    while (fgets(line, sizeof(line), decoder)) {
+        *moves += strncmp(line, "[GHOST MOVE]", strlen("[GHOST MOVE]")) == 0;
+    }
+    int status = pclose(decoder);
+    if (status == -1) {
+        fprintf(stderr, "Error: Failed to run '%s'.\n", command);
+    }
+    return header && status == 0;
+}
+
+/**
+ * Checks fp-trace against a trace written through the shared mapping: --follow
+ * prints the records traced after it started until the trace is closed, and a
+ * slot left unwritten is skipped and reported, by both decoders, without losing
+ * the records after it.
+ */
+static void checkTraceFollow() {
+    char path[] = "/tmp/fp-check-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        expect(C_FALSE, "a trace file can be created");
+        return;
+    }
+    close(fd);
+
+    char follow[sizeof(path) + 64], decode[sizeof(path) + 64];
+    snprintf(follow, sizeof(follow), "./fp-trace --follow %s 2>/dev/null", path);
+    snprintf(decode, sizeof(decode), "./fp-trace %s 2>/dev/null", path);
+    int room = internName("Hallway");
+    int moves;
+
+    setLogCategories(LOG_CAT_GHOST_MOVE);
+    if (!openTrace(path)) {
+        setLogCategories(0);
+        expect(C_FALSE, "a trace file can be opened");
+        return;
+    }
+    for (int i = 0; i < TRACE_CHECK_MOVES; i++) {
+        l_ghostMove(room);
+    }
+    FILE *decoder = popen(follow, "r");
+    for (int i = 0; i < TRACE_CHECK_MOVES; i++) {
+        l_ghostMove(room);
+    }
+    closeTrace();
+    setLogCategories(0);
+    expect(decoder && readTraceDecoder(follow, decoder, &moves) && moves == 2 * TRACE_CHECK_MOVES,
+           "fp-trace --follow prints every record until the trace is closed");
+
+    // Unpublish the first ghost move, as a writer that died before finishing it would
+    FILE *trace = fopen(path, "r+b");
+    TraceRecordType record;
+    long offset = sizeof(TraceHeaderType);
+    while (trace && fseek(trace, offset, SEEK_SET) == 0 && fread(&record, sizeof(record), 1, trace) == 1 &&
+           record.kind != LOG_GHOST_MOVE) {
+        offset += sizeof(record);
+    }
+    if (trace && record.kind == LOG_GHOST_MOVE && fseek(trace, offset, SEEK_SET) == 0) {
+        fputc(0, trace);
+    }
+    if (trace) {
+        fclose(trace);
+    }
+
+    decoder = popen(decode, "r");
+    expect(decoder && !readTraceDecoder(decode, decoder, &moves) && moves == 2 * TRACE_CHECK_MOVES - 1,
+           "fp-trace skips an unwritten slot, decodes the rest and fails");
+    decoder = popen(follow, "r");
+    expect(decoder && !readTraceDecoder(follow, decoder, &moves) && moves == 2 * TRACE_CHECK_MOVES - 1,
+           "fp-trace --follow skips an unwritten slot of a closed trace, decodes the rest and fails");
+    unlink(path);
+}
+
+/**
+ * Checks the log level and category parsers, the FP_LOG_* environment
+ * variables, and that only the chosen categories are logged.
+ */
+static void checkLogCategories() {
+    unsigned int categories = LOG_CAT_EXIT;
+    expect(parseLogLevel("off", &categories) && categories == 0, "level off logs nothing");
+    expect(parseLogLevel("info", &categories) && categories == LOG_LEVEL_INFO, "level info logs set up, reviews and exits");
+    expect(parseLogLevel("debug", &categories) && categories == LOG_CAT_ALL, "level debug logs everything");
+    expect(!parseLogLevel("verbose", &categories) && categories == LOG_CAT_ALL, "an unknown level is refused and changes nothing");
+
+    expect(parseLogCategories("ghost-evidence,exit", &categories) && categories == (LOG_CAT_GHOST_EVIDENCE | LOG_CAT_EXIT),
+           "a category list keeps the categories named");
+    expect(parseLogCategories("none", &categories) && categories == 0, "category none logs nothing");
+    expect(parseLogCategories("all", &categories) && categories == LOG_CAT_ALL, "category all logs everything");
+    expect(!parseLogCategories("init,haunting", &categories) && categories == LOG_CAT_ALL, "an unknown category is refused and changes nothing");
+    expect(!parseLogCategories("init,", &categories), "a category list ending in a comma is refused");
+
+    setenv("FP_LOG_LEVEL", "info", 1);
+    expect(logCategoriesFromEnv(0) == LOG_LEVEL_INFO, "FP_LOG_LEVEL chooses the level");
+    setenv("FP_LOG_CATEGORIES", "ghost-move", 1);
+    expect(logCategoriesFromEnv(0) == LOG_CAT_GHOST_MOVE, "FP_LOG_CATEGORIES overrides FP_LOG_LEVEL");
+    unsetenv("FP_LOG_LEVEL");
+    unsetenv("FP_LOG_CATEGORIES");
+    expect(logCategoriesFromEnv(LOG_CAT_EXIT) == LOG_CAT_EXIT, "without FP_LOG_* the default stays");
+
+    int saved;
+    FILE *capture = captureStdout(&saved);
+    setLogCategories(LOG_CAT_GHOST_MOVE);
+    l_hunterMove(internName("Hunter1"), internName("Hallway"));
+    l_ghostMove(internName("Hallway"));
+    l_ghostExit(LOG_FEAR);
+    setLogCategories(0);
+    restoreStdout(capture, saved);
+    char line[LOG_LINE_MAX];
+    int lines = 0, ghostMoves = 0;
+    while (fgets(line, sizeof(line), capture)) {
+        lines++;
+        ghostMoves += strncmp(line, "[GHOST MOVE]", strlen("[GHOST MOVE]")) == 0;
+    }
+    fclose(capture);
+    expect(lines == 1 && ghostMoves == 1, "only the chosen categories are logged");
+}
+
+int main() {
+    // The checks look at results, not at log lines
+    setLogCategories(0);
+
+    checkPhilox();
+    checkRngInt();
+    checkEventQueue();
+    checkRoomEvidence();
+    checkEvidenceSet();
+    checkRoomOccupancy();
+    checkArena();
+    checkArenaPool();
+    checkHunterLayout();
+    checkGhostTables();
+    checkNameTable();
+    checkLogWriter();
+    checkLogMerge();
+    checkTraceRecords();
+    checkTraceFollow();
+    checkLogCategories();
+
+    if (failures > 0) {
+        fprintf(stderr, "check: %d failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("check: all passed\n");
+    return 0;
+}
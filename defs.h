@@ -1,10 +1,21 @@
+#define _DEFAULT_SOURCE                         // MAP_ANONYMOUS and usleep alongside -std=c11
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <stdatomic.h>
 #include <time.h>
+#include <sched.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 #define MAX_STR         64
 #define MAX_RUNS        50
@@ -15,8 +26,52 @@
 #define GHOST_WAIT      600
 #define NUM_HUNTERS     4
 #define FEAR_MAX        10
-#define LOGGING         C_TRUE
 #define MAX_EV    3
+#define EVENT_GHOST     -1                      // event entity of the ghost, hunters use their index
+#define MAX_EVENTS      (NUM_HUNTERS + 1)
+#define SOA_LANES       4096                    // games stepped together by the struct-of-arrays engine
+#define LANE_ROOM_BITS  4                       // evidence bits per room in a lane
+#define EVIDENCE_BIT(ev) (1u << (ev))           // a room's evidence mask bit for one evidence type
+#define SUFFICIENT_EVIDENCE (EVIDENCE_BIT(EMF) | EVIDENCE_BIT(TEMPERATURE) | EVIDENCE_BIT(FINGERPRINTS)) // the types a review counts
+#define HUNTER_BIT(i)   (1u << (i))             // a room's occupancy bit for the hunter at index i
+#define ROOM_FLAG_START 0x1                     // hunters start here and the ghost never spawns here
+#define MAX_LANE_ROOMS  16                      // rooms whose evidence bits fit one 64-bit word
+#define HUNTER_TICKS    ((HUNTER_WAIT + GHOST_WAIT / 2) / GHOST_WAIT)   // ghost ticks per hunter action
+#define RNG_STREAM_SETUP    0                   // house stream: ghost class, ghost room, equipment
+#define RNG_STREAM_GHOST    1
+#define RNG_STREAM_HUNTER   2                   // hunter i draws from stream RNG_STREAM_HUNTER + i
+#define RNG_BLOCK_WORDS     4                   // random words per Philox4x32 block
+#define PHILOX_ROUNDS       10
+#define RNG_BENCH_DRAWS     (1L << 25)          // draws timed per generator by --bench rng
+#define RNG_BENCH_BATCH     1024                // counters per philoxFill call in the benchmark
+#define ARENA_BLOCK_SIZE    16384               // bytes per arena block, a game's whole house fits in one
+#define ARENA_ALIGN         16                  // alignment of every arena allocation
+#define CACHE_LINE          64                  // bytes per cache line, the alignment of per-hunter hot state
+#define ARENA_CACHE_BLOCKS  4                   // released blocks each thread keeps for its next game
+#define ARENA_POOL_BLOCKS   1024                // standard blocks the process-wide lock-free pool can track
+#define MAX_NAMES           255                 // distinct room and hunter names a process can intern, so ids fit a trace byte
+#define LOG_RINGS           64                  // log rings, one per logging thread alive at a time
+#define LOG_RING_RECORDS    1024                // records per log ring, a power of two
+#define LOG_WRITE_BUFFER    4096                // bytes per write() of the log writer, at most PIPE_BUF
+#define LOG_LINE_MAX        256                 // longest formatted log line
+#define LOG_WRITER_IDLE     100                 // microseconds the log writer sleeps when every ring is empty
+#define LOG_CAT_INIT        0x01                // log categories: hunters and the ghost being set up
+#define LOG_CAT_HUNTER_MOVE 0x02
+#define LOG_CAT_GHOST_MOVE  0x04
+#define LOG_CAT_HUNTER_EVIDENCE 0x08            // evidence collected by hunters
+#define LOG_CAT_GHOST_EVIDENCE  0x10            // evidence left by the ghost
+#define LOG_CAT_REVIEW      0x20
+#define LOG_CAT_EXIT        0x40                // hunters and the ghost leaving
+#define LOG_CAT_ALL         0x7F
+#define LOG_LEVEL_INFO      (LOG_CAT_INIT | LOG_CAT_REVIEW | LOG_CAT_EXIT)  // categories of --log-level info
+#define TRACE_NONE          0xFF                // trace byte of a missing hunter or room name
+#define TRACE_MAGIC         0x3245434152545046ULL   // "FPTRACE2", the game word of a trace's header record
+#define TRACE_CLOSED        1                   // detail of a trace's header record once every record is in
+#define TRACE_MAP_CHUNK     (1 << 24)           // bytes a trace file starts at, and the least it grows by
+#define TRACE_MAP_RESERVE   (1ULL << 36)        // bytes of address space a trace is mapped into, its largest size
+#define TRACE_FOLLOW_IDLE   10000               // microseconds fp-trace --follow waits for more records
+#define GAME_CSV_HEADER     "game,ghost,outcome,identified,evidence,bored_hunters,fearful_hunters,ghost_boredom\n"   // first line of batch output
+#define RNG_UNIT(bits)      ((float)(int)((bits) >> 8) * (1.0f / 16777216.0f))  // 32 random bits to [0, 1)
 
 typedef enum EvidenceType EvidenceType;
 typedef enum GhostClass GhostClass;
@@ -26,53 +81,123 @@ typedef     struct  Room    RoomType;
 typedef     struct  House   HouseType;
 typedef     struct  RoomList    RoomListType;
 typedef     struct  RoomNode    RoomNodeType;
-typedef     struct  EvidenceList    EvidenceListType;
-typedef     struct  EvidenceNode    EvidenceNodeType;
 typedef     struct  Hunter   HunterType;
+typedef     struct  HunterInfo   HunterInfoType;
 typedef    struct  EvidenceArray EvidenceArrayType;
 typedef    struct  HunterArray HunterArrayType;
 typedef    struct  sharedState SharedGameState;
+typedef    struct  Rng RngType;
+typedef    struct  Arena ArenaType;
+typedef    struct  ArenaBlock ArenaBlockType;
+typedef    struct  LogRecord LogRecordType;
+typedef    struct  LogRing LogRingType;
+typedef    struct  TraceRecord TraceRecordType;
+typedef    struct  TraceHeader TraceHeaderType;
 
 
 
 enum EvidenceType { EMF, TEMPERATURE, FINGERPRINTS, SOUND, EV_COUNT, EV_UNKNOWN };
-enum GhostClass { POLTERGEIST, BANSHEE, BULLIES, PHANTOM, GHOST_COUNT, GH_UNKNOWN };
+
+// Every ghost class with its name and the evidence it leaves for each of the three
+// determineEvidenceType draws. The class enum and the name, evidence and
+// identification tables are all generated from this one list.
+#define GHOST_CLASSES(X) \
+    X(POLTERGEIST,  "Poltergeist",  EMF,          TEMPERATURE,  FINGERPRINTS) \
+    X(BANSHEE,      "Banshee",      EMF,          TEMPERATURE,  SOUND) \
+    X(BULLIES,      "Bullies",      EMF,          FINGERPRINTS, SOUND) \
+    X(PHANTOM,      "Phantom",      TEMPERATURE,  FINGERPRINTS, SOUND)
+
+#define GHOST_ENUM(ghost, name, first, second, third) ghost,
+enum GhostClass { GHOST_CLASSES(GHOST_ENUM) GHOST_COUNT, GH_UNKNOWN };
+
+extern const EvidenceType ghostEvidence[GHOST_COUNT][4];    // evidence per class and draw, padded to four columns
+extern const unsigned char ghostByMask[1 << EV_COUNT];      // GhostClass ^ GH_UNKNOWN per evidence mask
 enum LoggerDetails { LOG_FEAR, LOG_BORED, LOG_EVIDENCE, LOG_SUFFICIENT, LOG_INSUFFICIENT, LOG_UNKNOWN };
+enum EngineType { ENGINE_THREADED, ENGINE_TICK, ENGINE_EVENT, ENGINE_INLINE, ENGINE_SOA };
+enum GameOutcome { OUTCOME_GHOST_WINS, OUTCOME_HUNTERS_WIN, OUTCOME_GHOST_LEFT, OUTCOME_COUNT };
+// Trace slots are zero until their record is written, so no kind is 0
+enum LogRecordKind {
+    LOG_HUNTER_INIT = 1, LOG_HUNTER_MOVE, LOG_HUNTER_REVIEW, LOG_HUNTER_COLLECT, LOG_HUNTER_EXIT, LOG_HUNTER_LEFT,
+    LOG_EVIDENCE_COUNT, LOG_GHOST_INIT, LOG_GHOST_MOVE, LOG_GHOST_EVIDENCE, LOG_GHOST_EXIT, LOG_GHOST_THREAD,
+    LOG_GAME_RECORD, LOG_TRACE_HEADER, LOG_TRACE_NAME
+};
 
 // Helper Utilies
-int randInt(int,int);        // Pseudo-random number generator function
-float randFloat(float, float);  // Pseudo-random float generator function
-enum GhostClass randomGhost();  // Return a randomly selected a ghost type
+void rngKey(unsigned int, unsigned int[2]); // Philox key of a master seed
+void philoxFill(const unsigned int[2], const unsigned int (*restrict)[4], unsigned int (*restrict)[4], int); // Random blocks of many counters
+void rngInit(RngType*, unsigned int, long, int); // Start the stream of one entity of one game
+void rngNextBlock(RngType*);    // Move a stream on to its next block, once per action
+unsigned int rngNext(RngType*); // Next 32 random bits of a stream
+int rngInt(RngType*, int, int); // Pseudo-random integer in [min, max) drawn from a stream
+float rngFloat(RngType*, float, float); // Pseudo-random float in [min, max) drawn from a stream
+void initArena(ArenaType*);     // Start an empty arena
+void *arenaAlloc(ArenaType*, size_t); // Memory from an arena, released with the whole arena
+void *arenaAllocAligned(ArenaType*, size_t, size_t); // Arena memory on a power of two boundary
+void freeArena(ArenaType*);     // Release everything allocated from an arena
+void releaseArenaCache();       // Hand the arena blocks cached by the calling thread to the shared pool
+void setSynchronized(int);      // Turn semaphore locking on or off for the calling thread
+int syncWait(sem_t*);           // sem_wait unless locking is off
+int syncPost(sem_t*);           // sem_post unless locking is off
+enum GhostClass randomGhost(RngType*);  // Return a randomly selected a ghost type
 void ghostToString(enum GhostClass, char*); // Convert a ghost type to a string, stored in output paremeter
 void evidenceToString(enum EvidenceType, char*); // Convert an evidence type to a string, stored in output parameter
 
 // Logging Utilities
-void l_hunterInit(char* name, enum EvidenceType equipment);
-void l_hunterMove(char* name, char* room);
-void l_hunterReview(char* name, enum LoggerDetails reviewResult);
-void l_hunterCollect(char* name, enum EvidenceType evidence, char* room);
-void l_hunterExit(char* name, enum LoggerDetails reason);
-void l_ghostInit(enum GhostClass type, char* room);
-void l_ghostMove(char* room);
-void l_ghostEvidence(enum EvidenceType evidence, char* room);
+void l_hunterInit(int hunter, enum EvidenceType equipment);
+void l_hunterMove(int hunter, int room);
+void l_hunterReview(int hunter, enum LoggerDetails reviewResult);
+void l_hunterCollect(int hunter, enum EvidenceType evidence, int room);
+void l_hunterExit(int hunter, enum LoggerDetails reason);
+void l_hunterLeft(int hunter);
+void l_evidenceCount(enum EvidenceType evidence, int count);
+void l_ghostInit(enum GhostClass type, int room);
+void l_ghostMove(int room);
+void l_ghostEvidence(enum EvidenceType evidence, int room);
 void l_ghostExit(enum LoggerDetails reason);
+void l_ghostThread(unsigned long thread);
+void setLogCategories(unsigned int categories);
+unsigned int getLogCategories();
+int isLogging();
+int parseLogLevel(const char *level, unsigned int *categories);
+int parseLogCategories(const char *list, unsigned int *categories);
+unsigned int logCategoriesFromEnv(unsigned int categories);
+void startLogWriter();
+void stopLogWriter();
+void setLogClock(long game, long tick);
+int openTrace(const char *path);
+void closeTrace();
+int formatLogRecord(const LogRecordType *record, char *line);
+void encodeTraceRecord(const LogRecordType *record, TraceRecordType *trace);
+void decodeTraceRecord(const TraceRecordType *trace, LogRecordType *record);
 
 void populateRooms(HouseType* house);
 void freeHouse(HouseType *house); 
 
+struct Rng {
+    unsigned int key[2];
+    unsigned int counter[4];    // next block, stream, game low, game high
+    unsigned int block[RNG_BLOCK_WORDS];
+    int used;                   // words of block already drawn
+};
+
 struct Room {
-    char name[MAX_STR];
-    EvidenceListType *evidencelist;
-    HunterArrayType *hunterArray;
+    int nameId;                 // the room's name in the name table
+    atomic_uint evidence;       // EVIDENCE_BIT of every evidence type left here
+    atomic_uint hunters;        // HUNTER_BIT of every hunter in the room
     RoomListType *roomlist; 
     GhostType *ghost;
+    int id;                     // index in the house's room table
+    unsigned int flags;         // ROOM_FLAG_* bits
+    RoomType **neighbours;      // this room's slice of the house adjacency
+    int neighbourCount;
 };
 
 struct Ghost {
   RoomType *room;
   GhostClass ghostType;
   int boredomTime;
-  
+  RngType rng;
+
 };
 
 struct RoomNode {
@@ -87,39 +212,50 @@ struct RoomList {
     sem_t sem;
 } ;
 
+struct Arena {
+    ArenaBlockType *blocks;     // newest first, allocations come from the head
+};
+
  struct House{
+    ArenaType arena;            // owns every allocation of the game
     RoomListType* rooms;
     HunterArrayType* hunterArray;
     EvidenceArrayType* evidenceArray;
     int hunterCount;
-
+    int roomCount;
+    RoomType **roomTable;       // rooms by id, in room list order
+    int *adjacencyStart;        // roomCount + 1 offsets into adjacency
+    RoomType **adjacency;       // connected rooms, contiguous per room
+    RoomType *startRoom;        // the room flagged ROOM_FLAG_START
+    RoomType **spawnRooms;      // rooms the ghost may start in, in room list order
+    int spawnCount;
+    unsigned int seed;          // master seed and game index every stream of the game derives from
+    long game;
+    RngType rng;                // RNG_STREAM_SETUP
 };
 
-struct EvidenceList {
-  EvidenceNodeType *ehead;
-  EvidenceNodeType *etail;
-    sem_t sem;
-} ;
-
-struct EvidenceNode {
-    enum EvidenceType evidence;
-    struct EvidenceNode *next;
-} ;
-
+// The state a hunter touches on every action. Each hunter's block starts on its own
+// cache line, so hunter threads updating their fear and boredom never share a line.
 struct Hunter {
-    char name[MAX_STR];
-    EvidenceType equipment;
-    EvidenceArrayType *evidenceArray; 
+    _Alignas(CACHE_LINE) RoomType *room;
     int fear;
     int boredom;
-    RoomType *room;
+    EvidenceType equipment;
+    int index;                  // position in the house's hunter array, the hunter's occupancy bit
+    RngType rng;
+    HunterInfoType *info;       // cold metadata, kept out of the hot block
+} ;
+
+// What a hunter only needs for logging and reporting
+struct HunterInfo {
+    int nameId;                 // the hunter's name in the name table
+    EvidenceArrayType *evidenceArray; 
     pthread_t thread;
 } ;
 
 struct EvidenceArray {
-    EvidenceType *evidence;
-    int size,capacity;
-    sem_t sem;
+    atomic_uint mask;           // EVIDENCE_BIT of every collected evidence type
+    int capacity;               // most evidence types the set takes
 } ;
 
 struct HunterArray {
@@ -152,8 +288,148 @@ struct sharedState{
     int gameOver;
 };
 
+typedef struct GameResult {
+    GhostClass ghostType;
+    GhostClass identified;      // GH_UNKNOWN unless all three pieces of evidence were collected
+    enum GameOutcome outcome;
+    int evidenceCount;
+    int fearfulHunters;
+    int boredHunters;
+    int ghostBoredom;
+} GameResultType;
+
+// One log line before formatting. Names travel as name table ids and are only
+// turned into strings by whoever formats the record.
+struct LogRecord {
+    enum LogRecordKind kind;
+    unsigned int tick;          // the game's tick when the line was logged
+    long game;                  // the game the line belongs to
+    uint64_t stamp;             // monotonic nanoseconds when the record was queued, the writer's merge key
+    union {
+        struct {
+            int detail;         // evidence type, ghost class or LoggerDetails, by kind
+            int hunter;         // name id of the hunter, -1 for none
+            int room;           // name id of the room, -1 for none
+            int count;          // LOG_EVIDENCE_COUNT
+        };
+        unsigned long thread;   // LOG_GHOST_THREAD
+        GameResultType result;  // LOG_GAME_RECORD
+    };
+};
+
+// A log record as stored in a binary trace. A LOG_TRACE_NAME record carries the id
+// of a name in hunter and its length in detail, and is followed by the name itself,
+// zero padded to whole records. A LOG_GAME_RECORD keeps the ghost class in detail,
+// the identified class in hunter and the outcome in room.
+struct TraceRecord {
+    uint8_t kind;               // LogRecordKind
+    uint8_t detail;
+    uint8_t hunter;             // name id, TRACE_NONE for none
+    uint8_t room;               // name id, TRACE_NONE for none; the count of LOG_EVIDENCE_COUNT
+    uint32_t tick;              // the four counts of LOG_GAME_RECORD, a byte each
+    uint64_t game;              // the thread of LOG_GHOST_THREAD, TRACE_MAGIC in the header
+};
+
+// The start of a trace file, shared by every process writing the mapped file. Writers
+// reserve records by advancing end, grow the file before touching anything past size,
+// and publish each reservation by storing its first kind byte last.
+struct TraceHeader {
+    TraceRecordType magic;      // LOG_TRACE_HEADER record: tick is the record size, detail TRACE_CLOSED once done
+    atomic_ullong end;          // bytes reserved so far, this header included
+    atomic_ullong size;         // bytes the file has been grown to
+    atomic_ullong dropped;      // records reserved past size after the file failed to grow
+    unsigned long long unused;  // pads the header to whole records
+};
+
+typedef struct GameStats {
+    long games;
+    long outcomes[OUTCOME_COUNT];
+    long identified;
+} GameStatsType;
+
+typedef struct BatchOptions {
+    long games;
+    unsigned int logCategories;  // LOG_CAT_* bits of the game log lines printed
+    int logChosen;              // C_TRUE if a log level or categories were given, by option or environment
+    enum EngineType engine;
+    unsigned int seed;
+    int workers;
+    int shards;
+    int lanes;
+    int bench;                  // C_TRUE to time the random generators instead of playing games
+    const char *trace;          // binary trace file replacing the text log, or NULL
+    char names[NUM_HUNTERS][MAX_STR];
+} BatchOptionsType;
+
+typedef struct GameQueue {
+    long next;                  // first game still queued
+    long end;                   // one past the last queued game
+    pthread_mutex_t lock;
+} GameQueueType;
+
+typedef struct GamePool {
+    BatchOptionsType *options;
+    GameQueueType *queues;      // one per worker
+    int workers;
+} GamePoolType;
+
+typedef struct PoolWorker {
+    GamePoolType *pool;
+    int index;
+    GameStatsType stats;
+    pthread_t thread;
+} PoolWorkerType;
+
+typedef struct ShardSlot {
+    long first;                 // first game of the shard's slice
+    long end;                   // one past the last game of the slice
+    int finished;               // set by the shard once stats is complete
+    GameStatsType stats;
+} ShardSlotType;
+
+typedef struct GameEvent {
+    long time;                  // virtual time of the action
+    int entity;                 // EVENT_GHOST or a hunter index
+} GameEventType;
+
+typedef struct EventQueue {
+    GameEventType events[MAX_EVENTS];   // binary min-heap
+    int size;
+} EventQueueType;
+
+typedef struct GameLanes {
+    int lanes;                  // games stepped in lockstep, lane i of every array is game i
+    int rooms;
+    int van;                    // room the hunters start in
+    int neighbourStart[MAX_LANE_ROOMS + 1];             // offsets into neighbours
+    unsigned int neighbourThreshold[MAX_LANE_ROOMS];    // words rngInt redraws for the room's degree
+    int neighbours[MAX_LANE_ROOMS * MAX_LANE_ROOMS];
+    int spawnRooms[MAX_LANE_ROOMS];                     // rooms the ghost may start in
+    int spawnCount;
+
+    // Per-lane state lives inside the struct so the compiler can tell the arrays apart
+    unsigned int key[2];                                // Philox key of the batch seed
+    long game[SOA_LANES];       // game played in each lane, -1 when empty
+    long start[SOA_LANES];      // tick the lane's game started at
+    unsigned int counters[SOA_LANES][RNG_BLOCK_WORDS];  // block of the entity being stepped, per lane
+    unsigned int draws[SOA_LANES][RNG_BLOCK_WORDS];     // that block's random words
+    int active[SOA_LANES];
+    int ghostRoom[SOA_LANES];
+    int ghostBoredom[SOA_LANES];
+    int ghostClass[SOA_LANES];
+    int hunterCount[SOA_LANES];
+    int evidenceMask[SOA_LANES];                        // shared evidence, one bit per EvidenceType
+    int evidenceCount[SOA_LANES];
+    int hunterRoom[NUM_HUNTERS][SOA_LANES];
+    int hunterFear[NUM_HUNTERS][SOA_LANES];
+    int hunterBoredom[NUM_HUNTERS][SOA_LANES];
+    int hunterActive[NUM_HUNTERS][SOA_LANES];
+    int hunterEquipment[NUM_HUNTERS][SOA_LANES];
+    unsigned long long roomEvidence[SOA_LANES];         // LANE_ROOM_BITS evidence bits per room
+} GameLanesType;
+
 //main helpers
-void setupHouse(HouseType *house);
+void setupHouse(HouseType *house, unsigned int seed, long game);
 GhostType* prepareGhost(HouseType *house);
 void inputHunterNames(char names[][MAX_STR]); 
 void initializeHunters(HouseType *house, char names[][MAX_STR]);
@@ -161,74 +437,112 @@ void logHunterInitialization(HunterArrayType *hunterArray);
 void setupThreads(pthread_t *ghostThread, pthread_t hunterThreads[], SharedGameState *gameState, GhostType *ghost, HouseType *house);
 void waitForThreadsCompletion(pthread_t ghostThread, pthread_t hunterThreads[]);
 void evaluateGameOutcome(HouseType *house, GhostType *ghost);
-void cleanupResources(GhostType *ghost, HouseType *house);
+void tallyGameOutcome(HouseType *house, GhostType *ghost, GameResultType *result);
+
+//pool helpers
+int defaultWorkerCount();
+void runGamePool(BatchOptionsType *options, GameStatsType *stats);
+void *poolWorker(void *param);
+long takeGames(GameQueueType *queue, long max, long *first);
+int stealGames(GamePoolType *pool, int thief);
+
+//shard helpers
+int runGameShards(BatchOptionsType *options, GameStatsType *stats);
+void shardWorker(BatchOptionsType *options, ShardSlotType *slot);
+
+//struct-of-arrays helpers
+GameLanesType *createGameLanes(int laneCount);
+void initLaneTopology(GameLanesType *lanes);
+void freeGameLanes(GameLanesType *lanes);
+void playGameLanes(GameLanesType *lanes, BatchOptionsType *options, long first, long count, GameStatsType *stats);
+void initLane(GameLanesType *lanes, int l, unsigned int seed, long game, long tick);
+void fillLaneDraws(GameLanesType *lanes, long tick, int stream, int period);
+void stepGhostLanes(GameLanesType *lanes);
+void stepHunterLanes(GameLanesType *lanes, int h);
+void tallyLaneOutcome(GameLanesType *lanes, int l, GameResultType *result);
+
+//scheduler helpers
+long runGameTicked(HouseType *house, GhostType *ghost, SharedGameState *sharedState);
+long runGameInline(HouseType *house, GhostType *ghost);
+long runGameEvents(HouseType *house, GhostType *ghost, SharedGameState *sharedState);
+void initEventQueue(EventQueueType *queue);
+int isEventBefore(const GameEventType *a, const GameEventType *b);
+int pushEvent(EventQueueType *queue, long time, int entity);
+int popEvent(EventQueueType *queue, GameEventType *event);
+
+//benchmark helpers
+void runRngBenchmark(BatchOptionsType *options);
+
+//batch helpers
+int parseBatchOptions(int argc, char *argv[], BatchOptionsType *options);
+void printUsage(const char *program);
+int runBatch(BatchOptionsType *options);
+void playGameRange(BatchOptionsType *options, long first, long count, GameStatsType *stats);
+void playGame(BatchOptionsType *options, long game, GameResultType *result);
+void printGameRecord(long game, const GameResultType *result);
+int formatGameRecord(char *line, long game, const GameResultType *result);
+int l_gameRecord(long game, const GameResultType *result);
+void addGameResult(GameStatsType *stats, const GameResultType *result);
+void mergeGameStats(GameStatsType *into, const GameStatsType *from);
+void printGameStats(const GameStatsType *stats);
     
 
 void initEvidence(EvidenceType *evidence, enum EvidenceType type);
-void initEvidenceList(EvidenceListType *list);
 void initEvidenceArray(EvidenceArrayType *evidenceArray, int size);
 EvidenceType addEv(GhostType* ghost);
-EvidenceType determineEvidenceType(GhostClass ghostType);
+EvidenceType determineEvidenceType(GhostClass ghostType, RngType *rng);
 int isEvidenceCollected(EvidenceArrayType *evidenceArray, EvidenceType evidence);
 void reviewEv(EvidenceArrayType *evidenceArray, GhostType *ghost);
 GhostClass identifyGhostFromEvidence(EvidenceType evidence[3]);
+GhostClass identifyGhostFromMask(unsigned int mask);
+int countEvidence(EvidenceArrayType *evidenceArray);
 
 EvidenceType doesEvidenceExist(RoomType *room, EvidenceType hunterEquipment);
 int collectEv(EvidenceArrayType *evidenceArray, EvidenceType evidence);
-void freeEvidenceList(EvidenceListType *evidenceList);
-void freeHunterArray(HunterArrayType *hunterArray);
 
-void initHunterArray(HunterArrayType *hunterArray, int size);
-void initHunter(HunterType *hunter, const char *name, EvidenceType equipment, RoomType *room); 
+void initHunterArray(ArenaType *arena, HunterArrayType *hunterArray, int size);
+void initHunter(HouseType *house, HunterType *hunter, const char *name, EvidenceType equipment, RoomType *room); 
 int isHunterPresent(GhostType* ghost, HunterArrayType* list, int numHunters);
 void *hunterBehaviour(void *param);
 int addHunter(HunterArrayType *hunterArray, const HunterType *newHunter);
 void moveToRandomRoomHunter(HunterType *hunter, HouseType *house);
-void updateHunterState(HunterType *hunter, GhostType *ghosts, HouseType *house, EvidenceArrayType *sharedEvidence, SharedGameState *sharedState); 
+int updateHunterState(HunterType *hunter, GhostType *ghosts, HouseType *house, EvidenceArrayType *sharedEvidence, SharedGameState *sharedState); 
 int isSufficientEvidence(EvidenceArrayType *sharedEvidence); 
-void assignRandomEquipment(HunterArrayType* hunters, int numHunters);
-void freeEvidenceArray(EvidenceArrayType *evidenceArray);
-void removeHunter(HunterArrayType *hunters_list, HunterType* hunter);
-void clearHunterArray(HunterArrayType *hunterArray);
-void performHunterAction(HunterType *hunter, HouseType *house, EvidenceArrayType *sharedEvidence);
+void assignRandomEquipment(HunterArrayType* hunters, int numHunters, RngType *rng);
+int performHunterAction(HunterType *hunter, HouseType *house, EvidenceArrayType *sharedEvidence);
 void logHunterExit(HunterType *hunter);
 void decrementHunterCount(HouseType *house);
 void collectEvidenceIfNeeded(HunterType *hunter, EvidenceArrayType *sharedEvidence);
-void reviewEvidenceAndExitIfNeeded(HunterType *hunter, EvidenceArrayType *sharedEvidence);
-void freeHunterResources(HunterType *hunter);
+int reviewEvidenceAndExitIfNeeded(HunterType *hunter, EvidenceArrayType *sharedEvidence);
 
 int addEvidenceAndLog(HunterType *hunter, EvidenceArrayType *sharedEvidence, EvidenceType collectedEv);
 void initHouse(HouseType *house);
-void freeRoomList(RoomListType *roomList);
+void compileHouseLayout(HouseType *house);
+int internName(const char *name);
+const char *nameOf(int id);
+int nameCount();
 void initGhost(GhostType *ghost, enum GhostClass type, RoomType *room);
 void *ghostBehaviour(void *param);
-void updateGhost(GhostType *ghost, HunterArrayType *hunters, int numHunters, SharedGameState *sharedState); 
+int updateGhost(GhostType *ghost, HunterArrayType *hunters, int numHunters, SharedGameState *sharedState); 
 int isGhostPresent(GhostType* ghost, HunterType *hunter);
 void moveToRandomRoomGhost(GhostType *ghost);
-void freeGhost(GhostType *ghost);
 void initGhostBehavior(GhostBehaviorContext *context, GhostType *ghost, HouseType *house, HunterArrayType *hunters, SharedGameState *sharedState); 
 
-void initRoom(RoomType *room, const char *name);
-RoomType* createRoom(const char* name) ;
+void initRoom(RoomType *room, int nameId);
+RoomType* createRoom(HouseType *house, const char* name) ;
 //RoomListType *createRoom();
 // RoomListType *createRoomList();
 // HunterArrayType *createHunterArray(int initialCapacity);
 // EvidenceArrayType *createEvidenceArray(int initialCapacity);
 void initRoomList(RoomListType *list);
-void addRoom(RoomListType* list, RoomType* room);
-void connectRooms(RoomType* room1, RoomType* room2);
-void initializeAndConnect(RoomType* room, RoomType* otherRoom);
+void addRoom(ArenaType *arena, RoomListType* list, RoomType* room);
+void connectRooms(ArenaType *arena, RoomType* room1, RoomType* room2);
+void initializeAndConnect(ArenaType *arena, RoomType* room, RoomType* otherRoom);
 RoomType* getRandomRoom(HouseType *house);
-void freeRoom(RoomType *room); 
-void safelyFreeRoom(RoomType *room) ;
-int usleep(int);
 RoomType* getRandomRoomExcludeVan(HouseType *house); 
 int isValidGhostAndHunterList(GhostType* ghost, HunterArrayType* list, int numHunters);
-int isSameRoom(RoomType* room1, RoomType* room2);
 int isHunterAndHouseValid(HunterType *hunter, HouseType *house) ;
-int getRandomRoomIndex(int roomCount);
-RoomType* getRoomAtIndex(RoomListType *roomList, int index);
+int getRandomRoomIndex(int roomCount, RngType *rng);
+RoomType* getRoomAtIndex(RoomType *room, int index);
 void updateHunterLocation(HunterType *hunter, RoomType *newRoom);
-int isValidHouse(HouseType *house);
-int countNonVanRooms(RoomListType *roomList) ;
-RoomType* findRoomByIndex(RoomListType *roomList, int index);
\ No newline at end of file
+int isValidHouse(HouseType *house);
\ No newline at end of file
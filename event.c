@@ -0,0 +1,149 @@
+#include "defs.h"
+
+/**
+ * Plays a whole game on the calling thread as a discrete-event simulation.
+ *
+ * The ghost and every hunter are events in a min-heap keyed by the virtual
+ * time of their next action. The ghost is rescheduled GHOST_WAIT units after
+ * each action and hunters HUNTER_WAIT units after theirs, the same rates the
+ * threaded engine sleeps for, but virtual time jumps straight to the next
+ * event instead of waiting. Events due at the same time run ghost first, then
+ * hunters by index.
+ *
+ * Parameters:
+ *   house - A pointer to the HouseType structure, with hunters already placed.
+ *   ghost - A pointer to the GhostType structure.
+ *   sharedState - A pointer to the SharedGameState for this game.
+ *
+ * Returns:
+ *   long - The virtual time at which the game ended.
+ */
+long runGameEvents(HouseType *house, GhostType *ghost, SharedGameState *sharedState) {
+    if (!house || !ghost || !sharedState) {
+        fprintf(stderr, "Error: Invalid parameter(s) provided to runGameEvents.\n");
+        return 0;
+    }
+
+    HunterArrayType *hunters = house->hunterArray;
+    EventQueueType queue;
+    initEventQueue(&queue);
+
+    pushEvent(&queue, 0, EVENT_GHOST);
+    for (int i = 0; i < hunters->size; i++) {
+        pushEvent(&queue, 0, i);
+    }
+
+    GameEventType event = { 0, EVENT_GHOST };
+    while (!sharedState->gameOver && popEvent(&queue, &event)) {
+        setLogClock(house->game, event.time / GHOST_WAIT);
+        if (event.entity == EVENT_GHOST) {
+            if (updateGhost(ghost, hunters, hunters->size, sharedState)) {
+                pushEvent(&queue, event.time + GHOST_WAIT, EVENT_GHOST);
+            }
+            continue;
+        }
+
+        HunterType *hunter = &hunters->hunter[event.entity];
+        if (!updateHunterState(hunter, ghost, house, house->evidenceArray, sharedState)) {
+            continue; // the hunter has left the house, drop its events
+        }
+
+        if (house->hunterCount == 0 || countEvidence(house->evidenceArray) >= 3) {
+            sharedState->gameOver = 1;
+        } else {
+            pushEvent(&queue, event.time + HUNTER_WAIT, event.entity);
+        }
+    }
+
+    return event.time;
+}
+
+/**
+ * Initializes an empty event queue.
+ *
+ * Parameters:
+ *   queue - A pointer to the EventQueueType to be initialized.
+ */
+void initEventQueue(EventQueueType *queue) {
+    queue->size = 0;
+}
+
+/**
+ * Checks whether event a is due before event b, breaking ties by entity so the
+ * ghost goes first and hunters follow in index order.
+ */
+int isEventBefore(const GameEventType *a, const GameEventType *b) {
+    return a->time < b->time || (a->time == b->time && a->entity < b->entity);
+}
+
+/**
+ * Schedules an entity's next action.
+ *
+ * Parameters:
+ *   queue - A pointer to the EventQueueType.
+ *   time - The virtual time of the action.
+ *   entity - EVENT_GHOST or the hunter's index.
+ *
+ * Returns:
+ *   int - 1 on success, 0 if the queue is full.
+ */
+int pushEvent(EventQueueType *queue, long time, int entity) {
+    if (queue->size >= MAX_EVENTS) {
+        fprintf(stderr, "Error: Event queue is full.\n");
+        return 0;
+    }
+
+    // Sift the new event up from the bottom of the heap
+    int child = queue->size++;
+    GameEventType event = { time, entity };
+    while (child > 0) {
+        int parent = (child - 1) / 2;
+        if (!isEventBefore(&event, &queue->events[parent])) {
+            break;
+        }
+        queue->events[child] = queue->events[parent];
+        child = parent;
+    }
+    queue->events[child] = event;
+
+    return 1;
+}
+
+/**
+ * Removes the earliest scheduled event.
+ *
+ * Parameters:
+ *   queue - A pointer to the EventQueueType.
+ *   event - Output parameter receiving the event.
+ *
+ * Returns:
+ *   int - 1 if an event was removed, 0 if the queue was empty.
+ */
+int popEvent(EventQueueType *queue, GameEventType *event) {
+    if (queue->size == 0) {
+        return 0;
+    }
+
+    *event = queue->events[0];
+    GameEventType last = queue->events[--queue->size];
+
+    // Sift the last event down from the root
+    int parent = 0;
+    for (;;) {
+        int child = 2 * parent + 1;
+        if (child >= queue->size) {
+            break;
+        }
+        if (child + 1 < queue->size && isEventBefore(&queue->events[child + 1], &queue->events[child])) {
+            child++;
+        }
+        if (!isEventBefore(&queue->events[child], &last)) {
+            break;
+        }
+        queue->events[parent] = queue->events[child];
+        parent = child;
+    }
+    queue->events[parent] = last;
+
+    return 1;
+}
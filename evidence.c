@@ -1,10 +1,22 @@
 #include "defs.h"
 
-// Initializes an evidence array with a specified capacity.
+#define GHOST_EVIDENCE_ROW(ghost, name, first, second, third) [ghost] = { first, second, third },
+#define GHOST_MASK_ENTRY(ghost, name, first, second, third) \
+    [EVIDENCE_BIT(first) | EVIDENCE_BIT(second) | EVIDENCE_BIT(third)] = ghost ^ GH_UNKNOWN,
+
+// The evidence each ghost class leaves, indexed by class and determineEvidenceType draw
+const EvidenceType ghostEvidence[GHOST_COUNT][4] = { GHOST_CLASSES(GHOST_EVIDENCE_ROW) };
+
+// The ghost class every evidence mask identifies. Entries hold the class xor GH_UNKNOWN
+// so the masks no ghost leaves, left zero, read back as GH_UNKNOWN.
+const unsigned char ghostByMask[1 << EV_COUNT] = { GHOST_CLASSES(GHOST_MASK_ENTRY) };
+
+// Initializes an evidence set with a specified capacity. The set is one atomic
+// word holding EVIDENCE_BIT of every collected type, so it needs no memory or lock.
 //
 // Parameters:
-//   evidenceArray - A pointer to the evidence array to be initialized.
-//   capacity - The capacity of the evidence array.
+//   evidenceArray - A pointer to the evidence set to be initialized.
+//   capacity - The most evidence types the set will hold.
 //
 // Returns: None.
 void initEvidenceArray(EvidenceArrayType *evidenceArray, int capacity) {
@@ -15,99 +27,35 @@ void initEvidenceArray(EvidenceArrayType *evidenceArray, int capacity) {
 
     if (capacity <= 0) {
         fprintf(stderr, "Error: Invalid capacity for evidence array (%d).\n", capacity);
-        evidenceArray->evidence = NULL;
-        evidenceArray->size = 0;
-        evidenceArray->capacity = 0;
-        return; 
-    }
-
-    // alocate memory 
-    evidenceArray->evidence = (EvidenceType *)malloc(capacity * sizeof(EvidenceType));
-    if (evidenceArray->evidence == NULL) {
-        fprintf(stderr, "Error: Failed to allocate memory for evidence array.\n");
-        evidenceArray->size = 0;
-        evidenceArray->capacity = 0;
-        return; 
+        capacity = 0;
     }
 
-    //array fieds
-    evidenceArray->size = 0;
+    atomic_init(&evidenceArray->mask, 0u);
     evidenceArray->capacity = capacity;
-
-    // semaphore initaliziaion
-    if (sem_init(&evidenceArray->sem, 0, 1) != 0) {
-        fprintf(stderr, "Error: Failed to initialize semaphore for evidence array.\n");
-        free(evidenceArray->evidence); // clean up mem
-        evidenceArray->evidence = NULL;
-        evidenceArray->size = 0;
-        evidenceArray->capacity = 0;
-    }
 }
 
-
-// Initializes an evidence list, setting head and tail pointers to NULL
-// and initializing a semaphore for thread safety.
-//
-// Parameters:
-//   evidenceList - A pointer to the evidence list to be initialized.
-//
-// Returns: None.
-void initEvidenceList(EvidenceListType *evidenceList) {
-    //check if null
-    if (!evidenceList) {
-        fprintf(stderr, "Error: Attempted to initialize a null EvidenceListType pointer.\n");
-        return; 
-    }
-
-    evidenceList->etail = NULL;
-    evidenceList->ehead = NULL;
-
-    // thread safety
-    if (sem_init(&evidenceList->sem, 0, 1) != 0) {
-        fprintf(stderr, "Error: Semaphore initialization failed for EvidenceListType.\n");
-        
-    }
-}
-
-// Adds evidence to the room's evidence list based on the ghost's type.
+// Leaves evidence of the ghost's type in the ghost's room. Only the evidence
+// types matter, so the room keeps one bit per type and leaving evidence is a
+// single atomic fetch_or, safe against hunters reading the room concurrently.
 //
 // Parameters:
 //   ghost - A pointer to the ghost whose evidence is to be added.
 //
 // Returns:
-//   EvidenceType - The type of evidence added to the list.
-//                  Returns EV_UNKNOWN if invalid parameters are provided or memory allocation fails.
+//   EvidenceType - The type of evidence left in the room.
+//                  Returns EV_UNKNOWN if invalid parameters are provided.
 EvidenceType addEv(GhostType* ghost) {
     // validate ghost
-    if (!ghost || !ghost->room || !ghost->room->evidencelist) {
+    if (!ghost || !ghost->room) {
         fprintf(stderr, "Error: Invalid ghost or room configuration.\n");
         return EV_UNKNOWN; //ret unknow ev
     }
 
     // det ev type and use helper func
-    EvidenceType evidenceToAdd = determineEvidenceType(ghost->ghostType); // Assume this function is defined elsewhere
-
-    EvidenceNodeType* newNode = (EvidenceNodeType*)malloc(sizeof(EvidenceNodeType));
-    if (!newNode) {
-        fprintf(stderr, "Error: Failed to allocate memory for new evidence node.\n");
-        return EV_UNKNOWN; // failed
-    }
-    //new node
-    newNode->evidence = evidenceToAdd;
-    newNode->next = NULL;
-
-    // Tthread safety
-    sem_wait(&ghost->room->evidencelist->sem); 
-    if (!ghost->room->evidencelist->ehead) {
-        
-        //new node is both head and tail now 
-        ghost->room->evidencelist->ehead = ghost->room->evidencelist->etail = newNode;
-    } else {
-        // append
-        ghost->room->evidencelist->etail->next = newNode;
-        ghost->room->evidencelist->etail = newNode;
+    EvidenceType evidenceToAdd = determineEvidenceType(ghost->ghostType, &ghost->rng);
+    if (evidenceToAdd < EV_COUNT) {
+        atomic_fetch_or_explicit(&ghost->room->evidence, EVIDENCE_BIT(evidenceToAdd), memory_order_relaxed);
     }
-    sem_post(&ghost->room->evidencelist->sem); 
 
     return evidenceToAdd; 
 }
@@ -116,24 +64,21 @@ EvidenceType addEv(GhostType* ghost) {
 //
 // Parameters:
 //   ghostType - The class/type of the ghost.
+//   rng - The ghost's random stream.
 //
 // Returns:
 //   EvidenceType - The determined type of evidence associated with the given ghost class.
-EvidenceType determineEvidenceType(GhostClass ghostType) {
-    int choice = randInt(0, 3); 
-    switch (ghostType) {
-        case POLTERGEIST: return (choice == 0) ? EMF : (choice == 1) ? TEMPERATURE : FINGERPRINTS;
-        case BANSHEE:     return (choice == 0) ? EMF : (choice == 1) ? TEMPERATURE : SOUND;
-        case BULLIES:     return (choice == 0) ? EMF : (choice == 1) ? FINGERPRINTS : SOUND;
-        case PHANTOM:     return (choice == 0) ? TEMPERATURE : (choice == 1) ? FINGERPRINTS : SOUND;
-        default:          return EV_UNKNOWN; 
-    }
+EvidenceType determineEvidenceType(GhostClass ghostType, RngType *rng) {
+    int choice = rngInt(rng, 0, 3); 
+    return ((unsigned int)ghostType < GHOST_COUNT) ? ghostEvidence[ghostType][choice] : EV_UNKNOWN;
 }
 
-// Collects a specific type of evidence and adds it to the evidence array.
+// Collects a specific type of evidence into the evidence set. The type's bit is
+// set with a compare-and-swap that fails on a full set or a duplicate, so
+// hunters collecting at the same time never wait on each other.
 //
 // Parameters:
-//   evidenceArray - A pointer to the evidence array where the evidence will be added.
+//   evidenceArray - A pointer to the evidence set where the evidence will be added.
 //   evidence - The type of evidence to be collected.
 //
 // Returns:
@@ -146,47 +91,47 @@ int collectEv(EvidenceArrayType *evidenceArray, EvidenceType evidence) {
         return -1; }
 
     // check the evidence type
-    if (evidence >= EV_UNKNOWN || evidence < EMF) {
+    if (evidence >= EV_COUNT || evidence < EMF) {
         fprintf(stderr, "Error: Invalid evidence type provided: %d.\n", evidence);
         return -1;  
     }
 
-    sem_wait(&evidenceArray->sem);
-
-
-    //add if enough space in arr
-    if (evidenceArray->size >= MAX_EV) {
-        fprintf(stderr, "Error: Cannot collect evidence, array is full.\n");
-    } else if (isEvidenceCollected(evidenceArray, evidence)) {
-        fprintf(stderr, "Error: Evidence type %d already collected.\n", evidence);
-    } else {
-        // add new evidence to the array
-        evidenceArray->evidence[evidenceArray->size++] = evidence;
-        fprintf(stdout, "Collected evidence type %d, total count: %d.\n", evidence, evidenceArray->size);
-        sem_post(&evidenceArray->sem);  
-        return 1;  
-    }
-
+    unsigned int bit = EVIDENCE_BIT(evidence);
+    unsigned int mask = atomic_load_explicit(&evidenceArray->mask, memory_order_acquire);
+    do {
+        // a full set or a duplicate is a normal part of play, not an error to report
+        if (__builtin_popcount(mask) >= evidenceArray->capacity || (mask & bit)) {
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&evidenceArray->mask, &mask, mask | bit,
+                                                    memory_order_acq_rel, memory_order_acquire));
 
-    sem_post(&evidenceArray->sem);
-    return -1; 
+    l_evidenceCount(evidence, __builtin_popcount(mask | bit));
+    return 1;
 }
 
-// Helper function to check if a specific type of evidence is already collected in the evidence array.
+// Helper function to check if a specific type of evidence is already collected in the evidence set.
 //
 // Parameters:
-//   evidenceArray - A pointer to the evidence array to be checked.
+//   evidenceArray - A pointer to the evidence set to be checked.
 //   evidence - The type of evidence to check for.
 //
 // Returns:
 //   int - Returns 1 if the evidence is already collected, 0 otherwise.
 int isEvidenceCollected(EvidenceArrayType *evidenceArray, EvidenceType evidence) {
-    for (int i = 0; i < evidenceArray->size; i++) {
-        if (evidenceArray->evidence[i] == evidence) {
-            return 1;  // ev is already collected
-        }
-    }
-    return 0;  // ev not collected yet
+    unsigned int mask = atomic_load_explicit(&evidenceArray->mask, memory_order_acquire);
+    return evidence >= EMF && evidence < EV_COUNT && (mask & EVIDENCE_BIT(evidence)) != 0;
+}
+
+// Counts the evidence types collected in the evidence set.
+//
+// Parameters:
+//   evidenceArray - A pointer to the evidence set to be counted.
+//
+// Returns:
+//   int - The number of distinct evidence types collected.
+int countEvidence(EvidenceArrayType *evidenceArray) {
+    return __builtin_popcount(atomic_load_explicit(&evidenceArray->mask, memory_order_acquire));
 }
 
 
@@ -201,38 +146,36 @@ int isEvidenceCollected(EvidenceArrayType *evidenceArray, EvidenceType evidence)
 //                  or EV_UNKNOWN if not found.
 EvidenceType doesEvidenceExist(RoomType *room, EvidenceType hunterEquipment) {
 
-    if (!room || !room->evidencelist) {
-        fprintf(stderr, "Error: Invalid room or evidence list.\n");
+    if (!room) {
+        fprintf(stderr, "Error: Invalid room.\n");
         return EV_UNKNOWN;  
     }
 
-    for (EvidenceNodeType *node = room->evidencelist->ehead; node != NULL; node = node->next) {
-        if (node->evidence == hunterEquipment) {
-            return node->evidence; // ret  matching evidence type
-        }
+    if (hunterEquipment < EMF || hunterEquipment >= EV_COUNT) {
+        return EV_UNKNOWN;
     }
 
-    return EV_UNKNOWN; // No evidence found
+    unsigned int evidence = atomic_load_explicit(&room->evidence, memory_order_relaxed);
+    return (evidence & EVIDENCE_BIT(hunterEquipment)) ? hunterEquipment : EV_UNKNOWN;
 }
 
-// Reviews the collected evidence in an array to identify the ghost type.
+// Reviews the collected evidence in a set to identify the ghost type.
 //
 // Parameters:
-//   evidenceArray - A pointer to the array of collected evidence.
+//   evidenceArray - A pointer to the set of collected evidence.
 //   ghost - A pointer to the ghost being investigated.
 //
 // Returns: None. Prints the result of the ghost identification based on the evidence.
 void reviewEv(EvidenceArrayType *evidenceArray, GhostType *ghost) {
+    unsigned int mask = evidenceArray ? atomic_load_explicit(&evidenceArray->mask, memory_order_acquire) : 0;
+
     // validate 
-    if (!evidenceArray || evidenceArray->size != 3) {
+    if (!evidenceArray || __builtin_popcount(mask) != 3) {
         printf("Not enough evidence collected.\n");
         return;
     }
 
-    sem_wait(&evidenceArray->sem);
-
-    GhostClass identifiedGhostType = identifyGhostFromEvidence(evidenceArray->evidence);
-    sem_post(&evidenceArray->sem);
+    GhostClass identifiedGhostType = identifyGhostFromMask(mask);
 
     char ghostName[MAX_STR]; 
     ghostToString(identifiedGhostType, ghostName); 
@@ -253,71 +196,24 @@ void reviewEv(EvidenceArrayType *evidenceArray, GhostType *ghost) {
 // Returns:
 //   GhostClass - The identified class of the ghost based on the evidence.
 GhostClass identifyGhostFromEvidence(EvidenceType evidence[3]) {
-    int evidenceFlags[4] = {0}; 
-    
+    unsigned int mask = 0;
+
     for (int i = 0; i < 3; i++) {
         if (evidence[i] >= EMF && evidence[i] <= SOUND) {
-            evidenceFlags[evidence[i]] = 1;
+            mask |= EVIDENCE_BIT(evidence[i]);
         }
     }
 
-    // det the ghost type based on evidence
-    if (evidenceFlags[EMF] && evidenceFlags[TEMPERATURE] && evidenceFlags[FINGERPRINTS]) {
-        return POLTERGEIST;
-    } else if (evidenceFlags[EMF] && evidenceFlags[TEMPERATURE] && evidenceFlags[SOUND]) {
-        return BANSHEE;
-    } else if (evidenceFlags[EMF] && evidenceFlags[FINGERPRINTS] && evidenceFlags[SOUND]) {
-        return BULLIES;
-    } else if (evidenceFlags[TEMPERATURE] && evidenceFlags[FINGERPRINTS] && evidenceFlags[SOUND]) {
-        return PHANTOM;
-    }
-
-    return GH_UNKNOWN; // Return unknown if no match 
-}
-
-// Frees the memory allocated for an evidence array and destroys its semaphore.
-//
-// Parameters:
-//   evidenceArray - A pointer to the evidence array to be freed.
-//
-// Returns: None. Frees the allocated memory and destroys the semaphore.
-void freeEvidenceArray(EvidenceArrayType *evidenceArray) {
-    // Check if not null
-    if (!evidenceArray) {
-        fprintf(stderr, "Error: Attempted to free a NULL EvidenceArrayType.\n");
-        return; }
-
-    // ree the evidence array inside the structure
-    if (evidenceArray->evidence) {
-        free(evidenceArray->evidence);
-        evidenceArray->evidence = NULL; 
-    }
-
-    sem_destroy(&evidenceArray->sem);
-
+    return identifyGhostFromMask(mask);
 }
 
-// Frees the memory allocated for all nodes in an evidence list.
+// Helper function to identify the ghost from a set of evidence bits.
 //
 // Parameters:
-//   evidenceList - A pointer to the evidence list to be freed.
+//   mask - EVIDENCE_BIT of every collected evidence type.
 //
-// Returns: None. Frees all nodes in the list and resets the list's head and tail pointers.
-void freeEvidenceList(EvidenceListType *evidenceList) {
-
-    if (!evidenceList) {
-        fprintf(stderr, "Error: Attempted to free a NULL EvidenceListType.\n");
-        return;
-    }
-
-    EvidenceNodeType *current = evidenceList->ehead;
-    while (current) {
-        EvidenceNodeType *nextNode = current->next;
-        free(current);  
-        current = nextNode; 
-
-    // Reset
-    evidenceList->ehead = NULL;
-    evidenceList->etail = NULL;
+// Returns:
+//   GhostClass - The identified class of the ghost based on the evidence.
+GhostClass identifyGhostFromMask(unsigned int mask) {
+    return (GhostClass)(ghostByMask[mask & ((1u << EV_COUNT) - 1)] ^ GH_UNKNOWN);
 }
-}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "defs.h"
+
+#define GHOST_NAME(ghost, name, first, second, third) [ghost] = name,
+static const char *const ghostNames[GHOST_COUNT] = { GHOST_CLASSES(GHOST_NAME) };
+
+/*
+    Returns the string representation of the given enum EvidenceType.
+        in: type - the enum EvidenceType to convert
+        out: str - the string representation of the given enum EvidenceType, minimum 16 characters
+*/
+void evidenceToString(enum EvidenceType type, char* str) {
+    switch (type) {
+        case EMF:
+            strcpy(str, "EMF");
+            break;
+        case TEMPERATURE:
+            strcpy(str, "TEMPERATURE");
+            break;
+        case FINGERPRINTS:
+            strcpy(str, "FINGERPRINTS");
+            break;
+        case SOUND:
+            strcpy(str, "SOUND");
+            break;
+        default:
+            strcpy(str, "UNKNOWN");
+            break;
+    }
+}
+
+/* 
+    Returns the string representation of the given enum GhostClass.
+        in: ghost - the enum GhostClass to convert
+        out: buffer - the string representation of the given enum GhostClass, minimum 16 characters
+*/
+void ghostToString(enum GhostClass ghost, char* buffer) {
+    strcpy(buffer, ((unsigned int)ghost < GHOST_COUNT) ? ghostNames[ghost] : "Unknown");
+}
+
+/*
+    Returns the text of a hunter's or the ghost's reason for leaving.
+    in: reason - LOG_FEAR, LOG_BORED or LOG_EVIDENCE
+*/
+static const char *exitReason(int reason) {
+    switch (reason) {
+        case LOG_FEAR:
+            return "FEAR";
+        case LOG_BORED:
+            return "BORED";
+        case LOG_EVIDENCE:
+            return "EVIDENCE";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+/*
+    Formats one record as the log line it stands for.
+    in:  record - the record to format
+    out: line - receives the line and its newline, at least LOG_LINE_MAX bytes
+    return: the length of the line
+*/
+int formatLogRecord(const LogRecordType *record, char *line) {
+    char str[MAX_STR];
+    int length = 0;
+    line[0] = '\0';
+    switch (record->kind) {
+        case LOG_HUNTER_INIT:
+            evidenceToString(record->detail, str);
+            length = snprintf(line, LOG_LINE_MAX, "[HUNTER INIT] [%s] is a [%s] hunter\n", nameOf(record->hunter), str);
+            break;
+        case LOG_HUNTER_MOVE:
+            length = snprintf(line, LOG_LINE_MAX, "[HUNTER MOVE] [%s] has moved into [%s]\n", nameOf(record->hunter), nameOf(record->room));
+            break;
+        case LOG_HUNTER_REVIEW:
+            length = snprintf(line, LOG_LINE_MAX, "[HUNTER REVIEW] [%s] reviewed evidence and found [%s]\n", nameOf(record->hunter),
+                              record->detail == LOG_SUFFICIENT ? "SUFFICIENT" : record->detail == LOG_INSUFFICIENT ? "INSUFFICIENT" : "UNKNOWN");
+            break;
+        case LOG_HUNTER_COLLECT:
+            evidenceToString(record->detail, str);
+            length = snprintf(line, LOG_LINE_MAX, "[HUNTER EVIDENCE] [%s] found [%s] in [%s] and [COLLECTED]\n", nameOf(record->hunter), str, nameOf(record->room));
+            break;
+        case LOG_HUNTER_EXIT:
+            length = snprintf(line, LOG_LINE_MAX, "[HUNTER EXIT] [%s] exited because [%s]\n", nameOf(record->hunter), exitReason(record->detail));
+            break;
+        case LOG_HUNTER_LEFT:
+            length = snprintf(line, LOG_LINE_MAX, "Hunter %s has exited the game\n", nameOf(record->hunter));
+            break;
+        case LOG_EVIDENCE_COUNT:
+            length = snprintf(line, LOG_LINE_MAX, "Collected evidence type %d, total count: %d.\n", record->detail, record->count);
+            break;
+        case LOG_GHOST_INIT:
+            ghostToString(record->detail, str);
+            length = snprintf(line, LOG_LINE_MAX, "[GHOST INIT] Ghost is a [%s] in room [%s]\n", str, nameOf(record->room));
+            break;
+        case LOG_GHOST_MOVE:
+            length = snprintf(line, LOG_LINE_MAX, "[GHOST MOVE] Ghost has moved into [%s]\n", nameOf(record->room));
+            break;
+        case LOG_GHOST_EVIDENCE:
+            evidenceToString(record->detail, str);
+            length = snprintf(line, LOG_LINE_MAX, "[GHOST EVIDENCE] Ghost left [%s] in [%s]\n", str, nameOf(record->room));
+            break;
+        case LOG_GHOST_EXIT:
+            length = snprintf(line, LOG_LINE_MAX, "[GHOST EXIT] Exited because [%s]\n", exitReason(record->detail));
+            break;
+        case LOG_GHOST_THREAD:
+            length = snprintf(line, LOG_LINE_MAX, "Ghost thread id: %lu\n", record->thread);
+            break;
+        case LOG_GAME_RECORD:
+            length = formatGameRecord(line, record->game, &record->result);
+            break;
+        default:
+            break; // trace bookkeeping, no line of its own
+    }
+    // snprintf reports the untruncated length
+    return length < LOG_LINE_MAX ? length : LOG_LINE_MAX - 1;
+}
+
+/*
+    Packs a log record into a trace record.
+    in:  record - the record to pack
+    out: trace - receives the packed record
+*/
+void encodeTraceRecord(const LogRecordType *record, TraceRecordType *trace) {
+    trace->kind = (uint8_t)record->kind;
+    trace->detail = (uint8_t)record->detail;
+    trace->hunter = record->hunter >= 0 ? (uint8_t)record->hunter : TRACE_NONE;
+    trace->room = record->room >= 0 ? (uint8_t)record->room : TRACE_NONE;
+    trace->tick = record->tick;
+    trace->game = (uint64_t)record->game;
+    switch (record->kind) {
+        case LOG_EVIDENCE_COUNT:
+            trace->room = (uint8_t)record->count;
+            break;
+        case LOG_GHOST_THREAD:
+            trace->detail = trace->hunter = trace->room = 0;
+            trace->game = record->thread;
+            break;
+        case LOG_GAME_RECORD:
+            // Every field of a summary is an enum or a count that fits a byte
+            trace->detail = (uint8_t)record->result.ghostType;
+            trace->hunter = (uint8_t)record->result.identified;
+            trace->room = (uint8_t)record->result.outcome;
+            trace->tick = (uint32_t)record->result.evidenceCount | (uint32_t)record->result.fearfulHunters << 8 |
+                          (uint32_t)record->result.boredHunters << 16 | (uint32_t)record->result.ghostBoredom << 24;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+    Unpacks a trace record into the log record it was made from.
+    in:  trace - the packed record
+    out: record - receives the log record
+*/
+void decodeTraceRecord(const TraceRecordType *trace, LogRecordType *record) {
+    memset(record, 0, sizeof(LogRecordType));
+    record->kind = (enum LogRecordKind)trace->kind;
+    record->tick = trace->tick;
+    record->game = (long)trace->game;
+    record->detail = trace->detail;
+    record->hunter = trace->hunter != TRACE_NONE ? trace->hunter : -1;
+    record->room = trace->room != TRACE_NONE ? trace->room : -1;
+    switch (record->kind) {
+        case LOG_EVIDENCE_COUNT:
+            record->count = trace->room;
+            record->room = -1;
+            break;
+        case LOG_GHOST_THREAD:
+            record->thread = (unsigned long)trace->game;
+            record->game = 0;
+            break;
+        case LOG_GAME_RECORD:
+            record->tick = 0;
+            record->result.ghostType = (GhostClass)trace->detail;
+            record->result.identified = (GhostClass)trace->hunter;
+            record->result.outcome = (enum GameOutcome)trace->room;
+            record->result.evidenceCount = trace->tick & 0xFF;
+            record->result.fearfulHunters = (trace->tick >> 8) & 0xFF;
+            record->result.boredHunters = (trace->tick >> 16) & 0xFF;
+            record->result.ghostBoredom = (trace->tick >> 24) & 0xFF;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Formats a single game's summary as one CSV line.
+ *
+ * Parameters:
+ *   line - Output buffer of at least LOG_LINE_MAX bytes receiving the line and its newline.
+ *   game - Zero based index of the game within the batch.
+ *   result - Pointer to the game's summary.
+ *
+ * Returns:
+ *   int - The length of the line.
+ */
+int formatGameRecord(char *line, long game, const GameResultType *result) {
+    static const char *outcomes[OUTCOME_COUNT] = { "ghost", "hunters", "bored" };
+    char ghostName[MAX_STR];
+    char identifiedName[MAX_STR];
+
+    ghostToString(result->ghostType, ghostName);
+    ghostToString(result->identified, identifiedName);
+
+    return snprintf(line, LOG_LINE_MAX, "%ld,%s,%s,%s,%d,%d,%d,%d\n", game, ghostName, outcomes[result->outcome], identifiedName,
+                    result->evidenceCount, result->boredHunters, result->fearfulHunters, result->ghostBoredom);
+}
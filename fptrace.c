@@ -0,0 +1,292 @@
+#include "defs.h"
+
+/**
+ * Checks that a trace starts with the header fp --trace writes.
+ *
+ * Parameters:
+ *   magic - The first record of the trace.
+ *
+ * Returns:
+ *   int - 1 if it is an fp trace header, 0 otherwise.
+ */
+static int isTraceHeader(const TraceRecordType *magic) {
+    if (magic->kind != LOG_TRACE_HEADER || magic->game != TRACE_MAGIC || magic->tick != sizeof(TraceRecordType)) {
+        fprintf(stderr, "Error: Input is not an fp trace.\n");
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Interns the name a LOG_TRACE_NAME record defines, checking that it gets the
+ * id the trace gave it.
+ *
+ * Parameters:
+ *   trace - The LOG_TRACE_NAME record.
+ *   text - The records following it, holding the name zero padded.
+ *
+ * Returns:
+ *   int - 1 if the name has its traced id, 0 if the trace is out of order.
+ */
+static int traceName(const TraceRecordType *trace, const TraceRecordType *text) {
+    char name[MAX_STR];
+    size_t length = trace->detail < MAX_STR ? trace->detail : MAX_STR - 1;
+    memcpy(name, text, length);
+    name[length] = '\0';
+
+    // Shards repeat the names they share, always under the same ids
+    if (internName(name) != trace->hunter) {
+        fprintf(stderr, "Error: Trace name %d '%s' is out of order.\n", trace->hunter, name);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Checks that a slot holds a published record rather than zeros left by a writer
+ * that never finished it, or the name text of such a record.
+ *
+ * Parameters:
+ *   kind - The slot's kind byte.
+ *
+ * Returns:
+ *   int - 1 if it is a record kind, 0 otherwise.
+ */
+static int isTraceKind(uint8_t kind) {
+    return kind >= LOG_HUNTER_INIT && kind <= LOG_TRACE_NAME;
+}
+
+/**
+ * Reports what a decoded trace is missing.
+ *
+ * Parameters:
+ *   closed - Whether fp closed the trace.
+ *   lost - Slots inside the trace that were never written.
+ *   dropped - Records the trace had no room for, from its header.
+ *
+ * Returns:
+ *   int - 1 if nothing is missing, 0 otherwise.
+ */
+static int reportTraceLoss(int closed, unsigned long long lost, unsigned long long dropped) {
+    int complete = 1;
+    if (!closed) {
+        fprintf(stderr, "Error: Trace was not closed, records may be missing from its end.\n");
+        complete = 0;
+    }
+    if (lost > 0 || dropped > 0) {
+        fprintf(stderr, "Error: Trace lost records: %llu slots were never written, %llu records did not fit in the file.\n",
+                lost, dropped);
+        complete = 0;
+    }
+    return complete;
+}
+
+/**
+ * Returns the number of records holding the name of a LOG_TRACE_NAME record.
+ *
+ * Parameters:
+ *   trace - The LOG_TRACE_NAME record.
+ *
+ * Returns:
+ *   size_t - The records following it.
+ */
+static size_t traceNameRecords(const TraceRecordType *trace) {
+    return (trace->detail + sizeof(TraceRecordType) - 1) / sizeof(TraceRecordType);
+}
+
+/**
+ * Writes the log line of one traced record.
+ *
+ * Parameters:
+ *   trace - The record, neither a name nor a header.
+ *   out - Where the log line goes.
+ */
+static void printTraceRecord(const TraceRecordType *trace, FILE *out) {
+    LogRecordType record;
+    char line[LOG_LINE_MAX];
+    decodeTraceRecord(trace, &record);
+    formatLogRecord(&record, line);
+    fputs(line, out);
+}
+
+/**
+ * Decodes a binary trace written by fp --trace back into the text log, in the
+ * form fp --log prints it: the CSV header, then the log lines with each game's
+ * CSV record after them.
+ *
+ * The trace is a header followed by fixed-size records; names are defined by
+ * LOG_TRACE_NAME records before the first record using them and are interned
+ * here in the same order, so their ids carry over unchanged. Decoding runs to
+ * the end the header records; slots left unwritten by a writer that died or ran
+ * out of room are skipped, so the records after them still come out.
+ *
+ * Parameters:
+ *   in - The trace to read.
+ *   out - Where the log lines go.
+ *
+ * Returns:
+ *   int - 1 if the whole trace was decoded, 0 if it is not a trace or lost records.
+ */
+static int decodeTrace(FILE *in, FILE *out) {
+    TraceRecordType header[sizeof(TraceHeaderType) / sizeof(TraceRecordType)];
+    if (fread(header, sizeof(header), 1, in) != 1) {
+        fprintf(stderr, "Error: Input is not an fp trace.\n");
+        return 0;
+    }
+    if (!isTraceHeader(&header[0])) {
+        return 0;
+    }
+    unsigned long long end, size, dropped, lost = 0;
+    memcpy(&end, (char *)header + offsetof(TraceHeaderType, end), sizeof(end));
+    memcpy(&size, (char *)header + offsetof(TraceHeaderType, size), sizeof(size));
+    memcpy(&dropped, (char *)header + offsetof(TraceHeaderType, dropped), sizeof(dropped));
+    if (end > size) {
+        end = size;
+    }
+    fputs(GAME_CSV_HEADER, out);
+
+    TraceRecordType trace;
+    unsigned long long offset = sizeof(TraceHeaderType);
+    for (; offset < end && fread(&trace, sizeof(trace), 1, in) == 1; offset += sizeof(trace)) {
+        if (!isTraceKind(trace.kind)) {
+            lost++;
+        } else if (trace.kind == LOG_TRACE_NAME) {
+            // The name follows in whole records, zero padded
+            TraceRecordType text[MAX_STR / sizeof(TraceRecordType) + 1];
+            size_t records = traceNameRecords(&trace);
+            if (records > sizeof(text) / sizeof(TraceRecordType) || fread(text, sizeof(TraceRecordType), records, in) != records) {
+                fprintf(stderr, "Error: Trace ends inside a name.\n");
+                return 0;
+            }
+            if (!traceName(&trace, text)) {
+                return 0;
+            }
+            offset += records * sizeof(TraceRecordType);
+        } else if (trace.kind != LOG_TRACE_HEADER) {
+            printTraceRecord(&trace, out);
+        }
+    }
+
+    if (ferror(in)) {
+        fprintf(stderr, "Error: Failed to read the trace.\n");
+        return 0;
+    }
+    if (offset < end) {
+        fprintf(stderr, "Error: Trace ends %llu bytes early.\n", end - offset);
+        return 0;
+    }
+    return reportTraceLoss(header[0].detail == TRACE_CLOSED, lost, dropped);
+}
+
+/**
+ * Decodes a trace while fp is still writing it, by mapping the same file and
+ * printing each record as soon as its writer publishes it. An unwritten slot is
+ * waited for while the trace is open; once it is closed, every writer is done, so
+ * such slots are skipped and counted instead. Returns once the trace is closed
+ * and every record in it has been printed.
+ *
+ * Parameters:
+ *   path - The trace file.
+ *   out - Where the log lines go.
+ *
+ * Returns:
+ *   int - 1 if the whole trace was decoded, 0 if it is not a trace, is out of order or lost records.
+ */
+static int followTrace(const char *path, FILE *out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open trace file '%s'.\n", path);
+        return 0;
+    }
+    // The header has to be in the file already, or reading it would fault
+    struct stat status;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && (size_t)status.st_size >= sizeof(TraceHeaderType)) {
+        map = mmap(NULL, TRACE_MAP_RESERVE, PROT_READ, MAP_SHARED | MAP_NORESERVE, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map trace file '%s'.\n", path);
+        return 0;
+    }
+
+    TraceHeaderType *header = (TraceHeaderType *)map;
+    if (__atomic_load_n(&header->magic.kind, __ATOMIC_ACQUIRE) == 0 || !isTraceHeader(&header->magic)) {
+        munmap(map, TRACE_MAP_RESERVE);
+        return 0;
+    }
+    fputs(GAME_CSV_HEADER, out);
+
+    int decoded = 1;
+    unsigned long long offset = sizeof(TraceHeaderType), lost = 0;
+    for (;;) {
+        // Read the flag first: once closed, every reserved record is in
+        int closed = __atomic_load_n(&header->magic.detail, __ATOMIC_ACQUIRE) == TRACE_CLOSED;
+        unsigned long long end = atomic_load_explicit(&header->end, memory_order_acquire);
+        unsigned long long size = atomic_load_explicit(&header->size, memory_order_acquire);
+        if (end > size) {
+            end = size;
+        }
+
+        if (offset >= end && closed) {
+            decoded = reportTraceLoss(closed, lost, atomic_load(&header->dropped));
+            break;
+        }
+        const TraceRecordType *trace = (const TraceRecordType *)((char *)map + offset);
+        uint8_t kind = offset < end ? __atomic_load_n(&trace->kind, __ATOMIC_ACQUIRE) : 0;
+        if (!isTraceKind(kind)) {
+            if (closed) {
+                lost++;
+                offset += sizeof(TraceRecordType);
+                continue;
+            }
+            fflush(out);
+            usleep(TRACE_FOLLOW_IDLE);
+            continue;
+        }
+
+        if (kind == LOG_TRACE_NAME) {
+            // A name's records are written before its first kind byte is published
+            if (!traceName(trace, trace + 1)) {
+                decoded = 0;
+                break;
+            }
+            offset += sizeof(TraceRecordType) * (1 + traceNameRecords(trace));
+        } else {
+            if (kind != LOG_TRACE_HEADER) {
+                printTraceRecord(trace, out);
+            }
+            offset += sizeof(TraceRecordType);
+        }
+    }
+
+    munmap(map, TRACE_MAP_RESERVE);
+    return decoded;
+}
+
+int main(int argc, char *argv[]) {
+    int follow = argc > 1 && strcmp(argv[1], "--follow") == 0;
+    if (argc > 2 + follow || (follow && argc != 3)) {
+        fprintf(stderr, "Usage: %s [TRACE]              decode a trace written by fp --trace, or stdin, to the text log\n", argv[0]);
+        fprintf(stderr, "       %s --follow TRACE     decode a trace while fp is still writing it\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (follow) {
+        return followTrace(argv[2], stdout) ? 0 : EXIT_FAILURE;
+    }
+
+    FILE *in = stdin;
+    if (argc == 2 && strcmp(argv[1], "-") != 0) {
+        in = fopen(argv[1], "rb");
+        if (!in) {
+            fprintf(stderr, "Error: Cannot open trace file '%s'.\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    int decoded = decodeTrace(in, stdout);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return decoded ? 0 : EXIT_FAILURE;
+}
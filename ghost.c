@@ -22,16 +22,8 @@ void initGhost(GhostType *ghost, enum GhostClass type, RoomType *room) {
     ghost->room = room;
     ghost->boredomTime = 0;
 
-    //  a stack-allocated array to hold the room name if room is not NULL
-    char roomName[MAX_STR]; 
-
-    if (room && room->name) {
-        strncpy(roomName, room->name, MAX_STR);
-        roomName[MAX_STR - 1] = '\0'; 
-        l_ghostInit(ghost->ghostType, roomName);
-    } else {
-        l_ghostInit(ghost->ghostType, "No Room");
-    }
+    // An id of -1 logs as "No Room"
+    l_ghostInit(ghost->ghostType, room ? room->nameId : -1);
 }
 
 
@@ -44,42 +36,48 @@ void initGhost(GhostType *ghost, enum GhostClass type, RoomType *room) {
  *   numHunters - The number of hunters in the game.
  *   sharedState - A pointer to the SharedGameState representing the game's shared state.
  *
- * Returns: None.
+ * Returns:
+ *   int - C_TRUE while the ghost stays in the house, C_FALSE once it has left.
  */
-void updateGhost(GhostType *ghost, HunterArrayType *hunters, int numHunters, SharedGameState *sharedState) {
+int updateGhost(GhostType *ghost, HunterArrayType *hunters, int numHunters, SharedGameState *sharedState) {
     
     // Validate input parameters
     if (!ghost || !hunters || !sharedState) {
         fprintf(stderr, "Error: Invalid parameter provided to updateGhost.\n");
-        return; 
+        return C_FALSE; 
     }
 
+    // Every update draws from its own block of the ghost's stream
+    rngNextBlock(&ghost->rng);
+
     int isHunterInRoom = isHunterPresent(ghost, hunters, numHunters);
     ghost->boredomTime = isHunterInRoom ? 0 : ghost->boredomTime + 1;
     
     if (ghost->boredomTime >= BOREDOM_MAX) {
         l_ghostExit(LOG_BORED);
         sharedState->gameOver = 1; 
-        pthread_exit(NULL); 
+        return C_FALSE; 
     }
 
 
-    switch (randInt(0, 3)) {
+    switch (rngInt(&ghost->rng, 0, 3)) {
         case 0: 
             break;
         case 1: // add evidence 
             if (ghost->room) {
                 EvidenceType ev = addEv(ghost);
-                l_ghostEvidence(ev, ghost->room->name);
+                l_ghostEvidence(ev, ghost->room->nameId);
             }
             break;
         case 2: // if no hunter present then move to rand room
             if (!isHunterInRoom && ghost->room) {
                 moveToRandomRoomGhost(ghost); 
-                l_ghostMove(ghost->room->name);
+                l_ghostMove(ghost->room->nameId);
             }
             break;
     }
+
+    return C_TRUE;
 }
 
 /**
@@ -105,6 +103,7 @@ void initGhostBehavior(GhostBehaviorContext *context, GhostType *ghost, HouseTyp
     context->ghost = ghost;
     context->house = house;
     context->hunters = hunters;
+    context->numHunters = hunters->size;
     context->sharedState = sharedState;
 }
 
@@ -126,11 +125,17 @@ void *ghostBehaviour(void *param) {
         pthread_exit(NULL); 
     }
 
-    printf("Ghost thread id: %lu\n", (unsigned long)pthread_self());
+    setLogClock(context->house->game, 0);
+    l_ghostThread((unsigned long)pthread_self());
 
 
+    // Each pass of the loop stands for one tick of the fixed-tick engines
+    long tick = 0;
     for (; context->ghost->boredomTime < BOREDOM_MAX && !context->sharedState->gameOver; usleep(GHOST_WAIT)) {
-    updateGhost(context->ghost, context->hunters, context->numHunters, context->sharedState);
+    setLogClock(context->house->game, tick++);
+    if (!updateGhost(context->ghost, context->hunters, context->numHunters, context->sharedState)) {
+        break; // the ghost got bored and left
+    }
     if (context->ghost->boredomTime >= BOREDOM_MAX) {
         context->sharedState->gameOver = 1; // game over
         break; 
@@ -139,20 +144,3 @@ void *ghostBehaviour(void *param) {
 
     pthread_exit(NULL);
 }
-
-
-/**
- * Frees the memory allocated for a GhostType structure, including its dynamically allocated members.
- * 
- * Parameters:
- *   ghost - A pointer to the GhostType structure to be freed.
- * 
- * Returns: None.
- */
-void freeGhost(GhostType *ghost) {
-    // Check if the pointer is not null
-    if (!ghost) {
-        return;
-    }
-    free(ghost);
-}
\ No newline at end of file
@@ -1,60 +1,62 @@
 #include "defs.h"
 
 /*
-    Dynamically allocates several rooms and populates the provided house.
+    Allocates several rooms from the house's arena and populates the provided house.
     Note: You may modify this as long as room names and connections are maintained.
         out: house - the house to populate with rooms. Assumes house has been initialized.
 */
 void populateRooms(HouseType* house) {
     // First, create each room
 
-    // createRoom assumes that we dynamically allocate a room, initializes the values, and returns a RoomType*
+    // createRoom allocates a room from the house's arena, initializes the values, and returns a RoomType*
     // create functions are pretty typical, but it means errors are harder to return aside from NULL
-    struct Room* van                = createRoom("Van");
-    struct Room* hallway            = createRoom("Hallway");
-    struct Room* master_bedroom     = createRoom("Master Bedroom");
-    struct Room* boys_bedroom       = createRoom("Boy's Bedroom");
-    struct Room* bathroom           = createRoom("Bathroom");
-    struct Room* basement           = createRoom("Basement");
-    struct Room* basement_hallway   = createRoom("Basement Hallway");
-    struct Room* right_storage_room = createRoom("Right Storage Room");
-    struct Room* left_storage_room  = createRoom("Left Storage Room");
-    struct Room* kitchen            = createRoom("Kitchen");
-    struct Room* living_room        = createRoom("Living Room");
-    struct Room* garage             = createRoom("Garage");
-    struct Room* utility_room       = createRoom("Utility Room");
+    struct Room* van                = createRoom(house, "Van");
+    struct Room* hallway            = createRoom(house, "Hallway");
+    struct Room* master_bedroom     = createRoom(house, "Master Bedroom");
+    struct Room* boys_bedroom       = createRoom(house, "Boy's Bedroom");
+    struct Room* bathroom           = createRoom(house, "Bathroom");
+    struct Room* basement           = createRoom(house, "Basement");
+    struct Room* basement_hallway   = createRoom(house, "Basement Hallway");
+    struct Room* right_storage_room = createRoom(house, "Right Storage Room");
+    struct Room* left_storage_room  = createRoom(house, "Left Storage Room");
+    struct Room* kitchen            = createRoom(house, "Kitchen");
+    struct Room* living_room        = createRoom(house, "Living Room");
+    struct Room* garage             = createRoom(house, "Garage");
+    struct Room* utility_room       = createRoom(house, "Utility Room");
 
     // This adds each room to each other's room lists
     // All rooms are two-way connections
     // THIS IS INDIVIDUAL ROOM LISTS THAT CONTAINS ALL THE CONNECTIONS OF THE ROOMS IN THE HOUSE
-    connectRooms(van, hallway);
-    connectRooms(hallway, master_bedroom);
-    connectRooms(hallway, boys_bedroom);
-    connectRooms(hallway, bathroom);
-    connectRooms(hallway, kitchen);
-    connectRooms(hallway, basement);
-    connectRooms(basement, basement_hallway);
-    connectRooms(basement_hallway, right_storage_room);
-    connectRooms(basement_hallway, left_storage_room);
-    connectRooms(kitchen, living_room);
-    connectRooms(kitchen, garage);
-    connectRooms(garage, utility_room);
+    connectRooms(&house->arena, van, hallway);
+    connectRooms(&house->arena, hallway, master_bedroom);
+    connectRooms(&house->arena, hallway, boys_bedroom);
+    connectRooms(&house->arena, hallway, bathroom);
+    connectRooms(&house->arena, hallway, kitchen);
+    connectRooms(&house->arena, hallway, basement);
+    connectRooms(&house->arena, basement, basement_hallway);
+    connectRooms(&house->arena, basement_hallway, right_storage_room);
+    connectRooms(&house->arena, basement_hallway, left_storage_room);
+    connectRooms(&house->arena, kitchen, living_room);
+    connectRooms(&house->arena, kitchen, garage);
+    connectRooms(&house->arena, garage, utility_room);
 
     // Add each room to the house's room list
     // THIS IS THE HOUSEROOM LIST OF ALL THE ROOMS IN THE HOUSE
-    addRoom(house->rooms, van);
-    addRoom(house->rooms, hallway);
-    addRoom(house->rooms, master_bedroom);
-    addRoom(house->rooms, boys_bedroom);
-    addRoom(house->rooms, bathroom);
-    addRoom(house->rooms, basement);
-    addRoom(house->rooms, basement_hallway);
-    addRoom(house->rooms, right_storage_room);
-    addRoom(house->rooms, left_storage_room);
-    addRoom(house->rooms, kitchen);
-    addRoom(house->rooms, living_room);
-    addRoom(house->rooms, garage);
-    addRoom(house->rooms, utility_room);
+    addRoom(&house->arena, house->rooms, van);
+    addRoom(&house->arena, house->rooms, hallway);
+    addRoom(&house->arena, house->rooms, master_bedroom);
+    addRoom(&house->arena, house->rooms, boys_bedroom);
+    addRoom(&house->arena, house->rooms, bathroom);
+    addRoom(&house->arena, house->rooms, basement);
+    addRoom(&house->arena, house->rooms, basement_hallway);
+    addRoom(&house->arena, house->rooms, right_storage_room);
+    addRoom(&house->arena, house->rooms, left_storage_room);
+    addRoom(&house->arena, house->rooms, kitchen);
+    addRoom(&house->arena, house->rooms, living_room);
+    addRoom(&house->arena, house->rooms, garage);
+    addRoom(&house->arena, house->rooms, utility_room);
+
+    van->flags |= ROOM_FLAG_START;
 }
 
 /**
@@ -63,7 +65,8 @@ void populateRooms(HouseType* house) {
  * Parameters:
  *   house - A pointer to the HouseType structure to be initialized.
  *
- * Returns: None. The function initializes the house's rooms, hunter array, and evidence array.
+ * Returns: None. The function starts the house's arena and allocates the house's rooms,
+ *          hunter array, and evidence array from it.
  */
 void initHouse(HouseType *house) {
 
@@ -72,60 +75,112 @@ void initHouse(HouseType *house) {
         exit(EXIT_FAILURE); // Exit if house is NULL
     }
 
-    house->rooms = (RoomListType *)malloc(sizeof(RoomListType));
-    if (!house->rooms) {
-        fprintf(stderr, "Error: Failed to allocate memory for room list.\n");
-        exit(EXIT_FAILURE);
-    }
+    // Everything the game allocates comes from here and is released by freeHouse
+    initArena(&house->arena);
+
+    house->rooms = (RoomListType *)arenaAlloc(&house->arena, sizeof(RoomListType));
     initRoomList(house->rooms); 
 
-    house->hunterArray = (HunterArrayType *)malloc(sizeof(HunterArrayType));
-    if (!house->hunterArray) {
-        fprintf(stderr, "Error: Failed to allocate memory for hunter array.\n");
-        exit(EXIT_FAILURE);
-    }
-    initHunterArray(house->hunterArray, NUM_HUNTERS); 
+    house->hunterArray = (HunterArrayType *)arenaAlloc(&house->arena, sizeof(HunterArrayType));
+    initHunterArray(&house->arena, house->hunterArray, NUM_HUNTERS); 
 
-    house->evidenceArray = (EvidenceArrayType *)malloc(sizeof(EvidenceArrayType));
-    if (!house->evidenceArray) {
-        fprintf(stderr, "Error: Failed to allocate memory for evidence array.\n");
-        exit(EXIT_FAILURE);
-    }
+    house->evidenceArray = (EvidenceArrayType *)arenaAlloc(&house->arena, sizeof(EvidenceArrayType));
     initEvidenceArray(house->evidenceArray, MAX_EV); 
 
     house->hunterCount = NUM_HUNTERS;
+    house->roomCount = 0;
+    house->roomTable = NULL;
+    house->adjacencyStart = NULL;
+    house->adjacency = NULL;
+    house->startRoom = NULL;
+    house->spawnRooms = NULL;
+    house->spawnCount = 0;
+}
+
+/**
+ * Compiles the room lists of a populated house into flat tables. Rooms get ids
+ * in room list order, and every room's connections are stored back to back in
+ * one adjacency array (compressed sparse row form), in room list order, so a
+ * neighbour pick is a single indexed load instead of a list walk. The rooms
+ * without ROOM_FLAG_START are collected into the ghost's spawn table.
+ *
+ * Parameters:
+ *   house - A pointer to the HouseType structure, after populateRooms.
+ *
+ * Returns: None. The function fills the room tables and adjacency of the house.
+ */
+void compileHouseLayout(HouseType *house) {
+    if (!house || !house->rooms) {
+        fprintf(stderr, "Error: Invalid house provided to compileHouseLayout.\n");
+        return;
+    }
+
+    int roomCount = house->rooms->size;
+    int edges = 0;
+    for (RoomNodeType *node = house->rooms->rhead; node; node = node->next) {
+        edges += node->room->roomlist ? node->room->roomlist->size : 0;
+    }
+
+    house->roomTable = (RoomType **)arenaAlloc(&house->arena, sizeof(RoomType *) * roomCount);
+    house->adjacencyStart = (int *)arenaAlloc(&house->arena, sizeof(int) * (roomCount + 1));
+    house->adjacency = (RoomType **)arenaAlloc(&house->arena, sizeof(RoomType *) * edges);
+    house->spawnRooms = (RoomType **)arenaAlloc(&house->arena, sizeof(RoomType *) * roomCount);
+
+    int id = 0;
+    house->spawnCount = 0;
+    for (RoomNodeType *node = house->rooms->rhead; node; node = node->next) {
+        node->room->id = id;
+        house->roomTable[id++] = node->room;
+        if (node->room->flags & ROOM_FLAG_START) {
+            if (!house->startRoom) {
+                house->startRoom = node->room;
+            }
+        } else {
+            house->spawnRooms[house->spawnCount++] = node->room;
+        }
+    }
+    house->roomCount = roomCount;
+
+    int edge = 0;
+    for (id = 0; id < roomCount; id++) {
+        RoomType *room = house->roomTable[id];
+        house->adjacencyStart[id] = edge;
+        room->neighbours = house->adjacency + edge;
+        for (RoomNodeType *node = room->roomlist ? room->roomlist->rhead : NULL; node; node = node->next) {
+            house->adjacency[edge++] = node->room;
+        }
+        room->neighbourCount = edge - house->adjacencyStart[id];
+    }
+    house->adjacencyStart[roomCount] = edge;
 }
 
 /**
- * Creates a new room with the given name.
+ * Creates a new room with the given name, interning the name in the name table.
  *
  * Parameters:
+ *   house - The house the room belongs to, whose arena holds the room.
  *   name - The name of the new room to be created.
  *
  * Returns:
  *   RoomType* - A pointer to the newly created RoomType structure.
  */
-RoomType* createRoom(const char* name) {
+RoomType* createRoom(HouseType *house, const char* name) {
     // Validate the name parameter
     if (!name) {
         fprintf(stderr, "Error: Null name provided to createRoom.\n");
         exit(EXIT_FAILURE);
     }
 
-    // Allocate memory 
-    RoomType* newRoom = (RoomType*)malloc(sizeof(RoomType));
-    if (!newRoom) {
-        fprintf(stderr, "Error: Memory allocation for new room failed.\n");
-        exit(EXIT_FAILURE);
-    }
-
-    initRoom(newRoom, name);  
+    RoomType* newRoom = (RoomType*)arenaAlloc(&house->arena, sizeof(RoomType));
+    initRoom(newRoom, internName(name));  
 
     return newRoom;
 }
 
 /**
- * Frees all allocated resources within a HouseType structure.
+ * Frees all allocated resources within a HouseType structure. Rooms, lists,
+ * tables, hunters and the ghost all live in the house's arena, so releasing
+ * the arena frees the whole game in one go.
  *
  * Parameters:
  *   house - A pointer to the HouseType structure whose resources are to be freed.
@@ -134,11 +189,9 @@ RoomType* createRoom(const char* name) {
  */
 void freeHouse(HouseType *house) {
     if (!house) {return; }
-    else if (house->rooms != NULL) {
-        freeRoomList(house->rooms);
-    }
 
-    clearHunterArray(house->hunterArray); 
-    freeEvidenceArray(house->evidenceArray); 
-    
+    freeArena(&house->arena);
+    house->rooms = NULL;
+    house->hunterArray = NULL;
+    house->evidenceArray = NULL;
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "defs.h"
 
 /**
- * Initializes a HunterType structure with provided attributes.
+ * Initializes a HunterType structure with provided attributes. The name is
+ * interned in the name table, and its id and the other cold metadata go to
+ * a separate HunterInfoType in the arena.
  *
  * Parameters:
+ *   house - The house the hunter plays in.
  *   hunter - A pointer to the HunterType structure to be initialized.
  *   name - The name of the hunter.
  *   equipment - The type of equipment the hunter carries.
@@ -11,13 +14,14 @@
  *
  * Returns: None.
  */
-void initHunter(HunterType *hunter, const char *name, EvidenceType equipment, RoomType *room) {
-    if (!hunter) {
+void initHunter(HouseType *house, HunterType *hunter, const char *name, EvidenceType equipment, RoomType *room) {
+    if (!hunter || !house) {
         fprintf(stderr, "Error: Null pointer provided to initHunter.\n");
         return;
     }
+    hunter->info = (HunterInfoType *)arenaAlloc(&house->arena, sizeof(HunterInfoType));
     if (strlen(name) < MAX_STR) {
-        strcpy(hunter->name, name);
+        hunter->info->nameId = internName(name);
     } else {
         printf("Error: Name is too long in initHunter\n");
         return;
@@ -28,13 +32,10 @@ void initHunter(HunterType *hunter, const char *name, EvidenceType equipment, Ro
     hunter->fear = 0;
     hunter->boredom = 0;
     hunter->room = room;
+    hunter->index = -1;
 
-    hunter->evidenceArray = (EvidenceArrayType *)malloc(sizeof(EvidenceArrayType));
-    if (hunter->evidenceArray) {
-        initEvidenceArray(hunter->evidenceArray, MAX_EV);
-    } else {
-        fprintf(stderr, "Error: Memory allocation for evidence array failed.\n");
-    }
+    hunter->info->evidenceArray = (EvidenceArrayType *)arenaAlloc(&house->arena, sizeof(EvidenceArrayType));
+    initEvidenceArray(hunter->info->evidenceArray, MAX_EV);
 
 }   
 
@@ -42,12 +43,13 @@ void initHunter(HunterType *hunter, const char *name, EvidenceType equipment, Ro
  * Initializes a HunterArrayType structure with a specified initial capacity.
  * 
  * Parameters:
+ *   arena - The arena of the house, holding the array's storage.
  *   hunterArray - A pointer to the HunterArrayType structure to be initialized.
  *   initial_capacity - The initial capacity for the hunter array.
  * 
  * Returns: None. The function initializes the hunter array and sets its capacity.
  */
-void initHunterArray(HunterArrayType *hunterArray, int initial_capacity) {
+void initHunterArray(ArenaType *arena, HunterArrayType *hunterArray, int initial_capacity) {
 
     if (!hunterArray) {
         fprintf(stderr, "Error: Null pointer provided to initHunterArray.\n");
@@ -64,13 +66,7 @@ void initHunterArray(HunterArrayType *hunterArray, int initial_capacity) {
     }
 
     // Allocate memory 
-    hunterArray->hunter = (HunterType *)malloc(sizeof(HunterType) * initial_capacity);
-    if (!hunterArray->hunter) {
-        fprintf(stderr, "Error: Memory allocation for hunters failed.\n");
-        hunterArray->size = 0;
-        hunterArray->capacity = 0;
-        return; 
-    }
+    hunterArray->hunter = (HunterType *)arenaAllocAligned(arena, sizeof(HunterType) * initial_capacity, CACHE_LINE);
 
     // Initialize the size and capacity fields
     hunterArray->size = 0;
@@ -79,7 +75,6 @@ void initHunterArray(HunterArrayType *hunterArray, int initial_capacity) {
     // Initialize the semaphore for thread safety
     if (sem_init(&hunterArray->sem, 0, 1) != 0) {
         fprintf(stderr, "Error: Semaphore initialization failed in initHunterArray.\n");
-        free(hunterArray->hunter); // Clean up 
         hunterArray->hunter = NULL;
         hunterArray->size = 0;
         hunterArray->capacity = 0;
@@ -104,12 +99,12 @@ int addHunter(HunterArrayType *hunterArray, const HunterType *newHunter) {
     }
 
     // Synchronize access to hunterArray using a semaphore
-    sem_wait(&hunterArray->sem);
+    syncWait(&hunterArray->sem);
 
  
     if (hunterArray->size >= hunterArray->capacity) {
         fprintf(stderr, "Error: Hunter array has reached its capacity.\n");
-        sem_post(&hunterArray->sem);  
+        syncPost(&hunterArray->sem);  
         return -1;  
     }
 
@@ -118,7 +113,7 @@ int addHunter(HunterArrayType *hunterArray, const HunterType *newHunter) {
     hunterArray->size++;  // Increment
 
 
-    if (sem_post(&hunterArray->sem) != 0) {
+    if (syncPost(&hunterArray->sem) != 0) {
         printf("Error: Failed to release semaphore in addHunter\n");
         return -1;
     }
@@ -152,10 +147,16 @@ void *hunterBehaviour(void *param) {
     EvidenceArrayType *sharedEvidence = context->sharedEvidence;
     SharedGameState *sharedState = context->sharedState;
 
+    // Each pass of the loop stands for HUNTER_TICKS ticks of the fixed-tick engines
+    long tick = 0;
     for (; hunter->fear < FEAR_MAX && hunter->boredom < BOREDOM_MAX && !sharedState->gameOver; usleep(HUNTER_WAIT)) {
-        updateHunterState(hunter, context->ghosts, house, sharedEvidence, sharedState);
+        setLogClock(house->game, tick);
+        tick += HUNTER_TICKS;
+        if (!updateHunterState(hunter, context->ghosts, house, sharedEvidence, sharedState)) {
+            break; // the hunter has left the house
+        }
 
-        if (house->hunterCount == 0 || sharedEvidence->size >= 3) {
+        if (house->hunterCount == 0 || countEvidence(sharedEvidence) >= 3) {
             sharedState->gameOver = 1; // Set game over condition
             break; // Exit the loop
         }
@@ -174,15 +175,19 @@ void *hunterBehaviour(void *param) {
  *   sharedEvidence - A pointer to the EvidenceArrayType structure for shared evidence.
  *   sharedState - A pointer to the SharedGameState structure representing the game's shared state.
  *
- * Returns: None. The function updates the hunter's state based on interactions with ghosts and evidence.
+ * Returns:
+ *   int - C_TRUE while the hunter stays in the house, C_FALSE once it has left.
  */
-void updateHunterState(HunterType *hunter, GhostType *ghosts, HouseType *house, EvidenceArrayType *sharedEvidence, SharedGameState *sharedState) {
+int updateHunterState(HunterType *hunter, GhostType *ghosts, HouseType *house, EvidenceArrayType *sharedEvidence, SharedGameState *sharedState) {
     // Validate input parameters
     if (!hunter || !ghosts || !house || !sharedEvidence || !sharedState) {
         fprintf(stderr, "Error: Invalid parameter(s) provided to updateHunterState.\n");
-        return; 
+        return C_FALSE; 
     }
 
+    // Every update draws from its own block of the hunter's stream
+    rngNextBlock(&hunter->rng);
+
     // Check for ghost presence 
     int ghostPresence = isGhostPresent(ghosts, hunter);
     if (ghostPresence) {
@@ -196,11 +201,14 @@ void updateHunterState(HunterType *hunter, GhostType *ghosts, HouseType *house,
     if (hunter->fear >= FEAR_MAX || hunter->boredom >= BOREDOM_MAX) {
         logHunterExit(hunter); 
         decrementHunterCount(house); 
-        pthread_exit(NULL);
+        if (house->hunterCount == 0) {
+            sharedState->gameOver = 1; // last hunter out, nobody else will end the game
+        }
+        return C_FALSE;
     }
 
     // Perform actions based on random choice
-    performHunterAction(hunter, house, sharedEvidence); // Assuming performHunterAction is defined elsewhere
+    return performHunterAction(hunter, house, sharedEvidence);
 }
 
 /**
@@ -217,7 +225,7 @@ void logHunterExit(HunterType *hunter) {
     }
 
     // Log the hunter's exit with the provided message
-    printf("Hunter %s has exited the game\n", hunter->name);
+    l_hunterLeft(hunter->info->nameId);
 }
 
 /**
@@ -245,26 +253,25 @@ void decrementHunterCount(HouseType *house) {
  *
  * Parameters:
  *   hunter - A pointer to the HunterType structure representing the hunter.
- *   ghosts - A pointer to the GhostType structure representing the ghosts.
  *   house - A pointer to the HouseType structure representing the house.
  *   sharedEvidence - A pointer to the EvidenceArrayType structure for shared evidence.
- *   sharedState - A pointer to the SharedGameState structure representing the game's shared state.
  *
- * Returns: None. The function updates the hunter's state based on interactions with ghosts and evidence.
+ * Returns:
+ *   int - C_TRUE while the hunter stays in the house, C_FALSE if the review sent it home.
  */
-void performHunterAction(HunterType *hunter, HouseType *house, EvidenceArrayType *sharedEvidence) {
-       switch (randInt(0, 3)) {
+int performHunterAction(HunterType *hunter, HouseType *house, EvidenceArrayType *sharedEvidence) {
+       switch (rngInt(&hunter->rng, 0, 3)) {
         case 0: // Move to a random, connected room
             moveToRandomRoomHunter(hunter, house);
-            l_hunterMove(hunter->name, hunter->room->name);
+            l_hunterMove(hunter->info->nameId, hunter->room->nameId);
             break;
         case 1: // Collect evidence
             collectEvidenceIfNeeded(hunter, sharedEvidence);
             break;
         case 2: // Review evidence
-            reviewEvidenceAndExitIfNeeded(hunter, sharedEvidence);
-            break;
+            return reviewEvidenceAndExitIfNeeded(hunter, sharedEvidence);
     }
+    return C_TRUE;
 }
 
 // Helper function to collect evidence if present in the hunter's room
@@ -285,20 +292,21 @@ void collectEvidenceIfNeeded(HunterType *hunter, EvidenceArrayType *sharedEviden
 // Helper function to add evidence to the shared array and log the collection
 int addEvidenceAndLog(HunterType *hunter, EvidenceArrayType *sharedEvidence, EvidenceType collectedEv) {
     int added = collectEv(sharedEvidence, collectedEv);
-    if (added != 0) {
-        l_hunterCollect(hunter->name, collectedEv, hunter->room->name);
+    if (added == 1) {
+        l_hunterCollect(hunter->info->nameId, collectedEv, hunter->room->nameId);
     }
     return added;
 }
 
-// Helper function to review evidence and exit if sufficient
-void reviewEvidenceAndExitIfNeeded(HunterType *hunter, EvidenceArrayType *sharedEvidence) {
+// Helper function to review evidence, returns C_FALSE if the hunter leaves with sufficient evidence
+int reviewEvidenceAndExitIfNeeded(HunterType *hunter, EvidenceArrayType *sharedEvidence) {
     if (isSufficientEvidence(sharedEvidence) >= 3) {
-        l_hunterReview(hunter->name, LOG_SUFFICIENT);
-        pthread_exit(NULL);
-    } else {
-        l_hunterReview(hunter->name, LOG_INSUFFICIENT);
+        l_hunterReview(hunter->info->nameId, LOG_SUFFICIENT);
+        return C_FALSE;
     }
+
+    l_hunterReview(hunter->info->nameId, LOG_INSUFFICIENT);
+    return C_TRUE;
 }
 
 
@@ -318,25 +326,9 @@ int isSufficientEvidence(EvidenceArrayType *sharedEvidence) {
         return 0; 
     }
 
-    // Array to track occurrences of each evidence type
-    int evidenceOccurrence[MAX_EV] = {0};
-
-    for (int i = 0; i < sharedEvidence->size; i++) {
-        EvidenceType evType = sharedEvidence->evidence[i];
-        if (evType >= 0 && evType < MAX_EV) {
-            evidenceOccurrence[evType]++;
-        } else {
-            fprintf(stderr, "Warning: Encountered invalid evidence type: %d\n", evType);
-        }
-    }
-int uniqueEvidenceTypes = 0;
-// Count types of evidence
-int *evidenceEnd = evidenceOccurrence + MAX_EV; 
-for (int *ptr = evidenceOccurrence; ptr < evidenceEnd; ptr++) {
-    if (*ptr > 0) {
-        uniqueEvidenceTypes++;
-    }
-}
+    // Only the SUFFICIENT_EVIDENCE types count towards a review
+    unsigned int mask = atomic_load_explicit(&sharedEvidence->mask, memory_order_acquire);
+    int uniqueEvidenceTypes = __builtin_popcount(mask & SUFFICIENT_EVIDENCE);
 
     return uniqueEvidenceTypes;
 }
@@ -348,10 +340,11 @@ for (int *ptr = evidenceOccurrence; ptr < evidenceEnd; ptr++) {
  * Parameters:
  *   hunters - A pointer to the HunterArrayType structure containing the hunters.
  *   numHunters - The number of hunters to assign equipment to.
+ *   rng - The random stream to draw the equipment from.
  *
  * Returns: None.
  */
-void assignRandomEquipment(HunterArrayType *hunters, int numHunters) {
+void assignRandomEquipment(HunterArrayType *hunters, int numHunters, RngType *rng) {
     // Validate input parameters
     if (!hunters || !hunters->hunter || numHunters <= 0 || hunters->size < numHunters) {
         fprintf(stderr, "Error: Invalid parameters provided to assignRandomEquipment.\n");
@@ -369,81 +362,10 @@ void assignRandomEquipment(HunterArrayType *hunters, int numHunters) {
     for (int i = 0; i < numHunters; i++) {
         int equipmentIndex;
         do {
-            equipmentIndex = randInt(0, EV_COUNT - 1);
+            equipmentIndex = rngInt(rng, 0, EV_COUNT);
         } while (assignedEquipment[equipmentIndex]); 
 
         hunters->hunter[i].equipment = equipmentIndex;
         assignedEquipment[equipmentIndex] = 1;
     }
 }
-
-/**
- * Removes a specific hunter from the hunters list.
- *
- * Parameters:
- *   hunters_list - A pointer to the HunterArrayType structure containing the list of hunters.
- *   hunter - A pointer to the HunterType structure representing the hunter to be removed.
- *
- * Returns: None. The function removes the specified hunter from the list.
- */
-void removeHunter(HunterArrayType *hunters_list, HunterType *hunter) {
-    // Validate input parameters
-    if (!hunters_list || !hunter) {
-        fprintf(stderr, "Error: Invalid parameters provided to removeHunter.\n");
-        return;
-    }
-
-    // Iterate over the hunters list 
-    for (int index = 0; index < hunters_list->size; index++) {
-        if (strcmp(hunters_list->hunter[index].name, hunter->name) == 0) {
-
-            for (int j = index; j < hunters_list->size - 1; j++) {
-                hunters_list->hunter[j] = hunters_list->hunter[j + 1];
-            }
-            hunters_list->size--; // after removal
-            break; 
-        }
-    }
-}
-
-/**
- * Clears the hunter array, freeing all allocated resources.
- *
- * Parameters:
- *   hunterArray - A pointer to the HunterArrayType structure to be cleared.
- *
- * Returns: None. The function clears the hunter array and frees associated memory.
- */
-void clearHunterArray(HunterArrayType *hunterArray) {
-    // Validate the hunterArray pointer
-    if (!hunterArray) {
-        fprintf(stderr, "Error: Null pointer provided to clearHunterArray.\n");
-        return;
-    }
-
-   
-    for (int i = 0; i < hunterArray->size; i++) {
-        freeHunterResources(&hunterArray->hunter[i]);
-    }
-
-
-    free(hunterArray->hunter);
-    hunterArray->hunter = NULL; 
-    hunterArray->size = 0;
-    hunterArray->capacity = 0;
-}
-
-/**
- * Frees resources allocated for a single hunter.
- *
- * Parameters:
- *   hunter - A pointer to the HunterType structure whose resources are to be freed.
- *
- * Returns: None. The function frees the hunter's allocated resources.
- */
-void freeHunterResources(HunterType *hunter) {
-    if (hunter && hunter->evidenceArray) {
-        free(hunter->evidenceArray->evidence);
-        free(hunter->evidenceArray);
-    }
-}
\ No newline at end of file
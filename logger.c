@@ -1,90 +1,694 @@
 #include "defs.h"
 
-/* 
+// A single producer, single consumer queue of records. Only the thread owning the
+// ring pushes and only the log writer pops; each side keeps its index on its own
+// cache line, and the producer keeps a stale copy of the tail so it only reads the
+// writer's line when the ring looks full.
+struct LogRing {
+    _Alignas(CACHE_LINE) atomic_uint head;  // next slot the owner fills
+    _Atomic uint64_t watermark;             // no record still on its way to the ring is stamped earlier; UINT64_MAX if none is
+    uint64_t lastStamp;                     // the stamp of the owner's last record
+    unsigned int tailSeen;                  // the owner's last look at tail
+    _Alignas(CACHE_LINE) atomic_uint tail;  // next slot the writer formats
+    _Alignas(CACHE_LINE) atomic_int owned;  // C_TRUE while a thread pushes to this ring
+    LogRecordType records[LOG_RING_RECORDS];
+};
+
+// LOG_CAT_* bits of the lines logged; each l_* function tests its own bit first
+static unsigned int logCategories = LOG_CAT_ALL;
+
+static const struct {
+    const char *name;
+    unsigned int category;
+} logCategoryNames[] = {
+    { "init", LOG_CAT_INIT },
+    { "hunter-move", LOG_CAT_HUNTER_MOVE },
+    { "ghost-move", LOG_CAT_GHOST_MOVE },
+    { "hunter-evidence", LOG_CAT_HUNTER_EVIDENCE },
+    { "ghost-evidence", LOG_CAT_GHOST_EVIDENCE },
+    { "review", LOG_CAT_REVIEW },
+    { "exit", LOG_CAT_EXIT },
+    { "all", LOG_CAT_ALL },
+    { "none", 0 },
+};
+
+static LogRingType logRings[LOG_RINGS];
+static __thread LogRingType *threadRing = NULL;
+static pthread_key_t ringKey;
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+
+static atomic_int writerRunning = C_FALSE;
+static pthread_t writerThread;
+
+// Binary trace sink replacing the text log, mapped for the threads (and forked
+// shards) to append to, and how much of the name table it holds
+static int traceFd = -1;
+static TraceHeaderType *traceHeader = NULL;
+static atomic_int namesTraced = 0;
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t traceGrowLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Game and tick stamped on the records of the calling thread
+static __thread long clockGame = 0;
+static __thread unsigned int clockTick = 0;
+
+/*
+    Chooses the categories of game log lines printed from now on. Defaults to all of them.
+    in: categories - LOG_CAT_* bits, 0 to turn the log off
+*/
+void setLogCategories(unsigned int categories) {
+    logCategories = categories & LOG_CAT_ALL;
+}
+
+/*
+    Returns the LOG_CAT_* bits of the game log lines currently printed.
+*/
+unsigned int getLogCategories() {
+    return logCategories;
+}
+
+/*
+    Returns C_TRUE if any game log lines are currently printed.
+*/
+int isLogging() {
+    return logCategories != 0;
+}
+
+/*
+    Turns a log level into the categories it prints: off, info (set up, reviews
+    and exits) or debug (everything).
+    in:  level - the level's name
+    out: categories - receives the level's LOG_CAT_* bits
+    return: C_TRUE if the level is known, C_FALSE otherwise
+*/
+int parseLogLevel(const char *level, unsigned int *categories) {
+    if (strcmp(level, "off") == 0) {
+        *categories = 0;
+    } else if (strcmp(level, "info") == 0) {
+        *categories = LOG_LEVEL_INFO;
+    } else if (strcmp(level, "debug") == 0) {
+        *categories = LOG_CAT_ALL;
+    } else {
+        return C_FALSE;
+    }
+    return C_TRUE;
+}
+
+/*
+    Turns a comma separated list of category names, such as "ghost-evidence,exit",
+    into LOG_CAT_* bits.
+    in:  list - the category names
+    out: categories - receives the categories' LOG_CAT_* bits
+    return: C_TRUE if every name is known, C_FALSE otherwise
+*/
+int parseLogCategories(const char *list, unsigned int *categories) {
+    unsigned int parsed = 0;
+    for (;;) {
+        size_t length = strcspn(list, ",");
+        size_t known = 0;
+        for (; known < sizeof(logCategoryNames) / sizeof(logCategoryNames[0]); known++) {
+            if (strlen(logCategoryNames[known].name) == length && strncmp(logCategoryNames[known].name, list, length) == 0) {
+                break;
+            }
+        }
+        if (known == sizeof(logCategoryNames) / sizeof(logCategoryNames[0])) {
+            return C_FALSE;
+        }
+        parsed |= logCategoryNames[known].category;
+        list += length;
+        if (*list != ',') {
+            break;
+        }
+        list++;
+    }
+    *categories = parsed;
+    return C_TRUE;
+}
+
+/*
+    Applies the FP_LOG_LEVEL and then the FP_LOG_CATEGORIES environment variables,
+    where set, to a default choice of categories. Bad values are reported and ignored.
+    in: categories - the LOG_CAT_* bits to start from
+    return: the LOG_CAT_* bits chosen
+*/
+unsigned int logCategoriesFromEnv(unsigned int categories) {
+    const char *level = getenv("FP_LOG_LEVEL");
+    if (level && !parseLogLevel(level, &categories)) {
+        fprintf(stderr, "Error: Unknown log level '%s' in FP_LOG_LEVEL.\n", level);
+    }
+    const char *list = getenv("FP_LOG_CATEGORIES");
+    if (list && !parseLogCategories(list, &categories)) {
+        fprintf(stderr, "Error: Unknown log categories '%s' in FP_LOG_CATEGORIES.\n", list);
+    }
+    return categories;
+}
+
+/*
+    Sets the game and tick stamped on the records the calling thread logs from now on.
+    in: game - the index of the game being played
+    in: tick - the game's current tick
+*/
+void setLogClock(long game, long tick) {
+    clockGame = game;
+    clockTick = (unsigned int)tick;
+}
+
+/*
+    Writes a whole buffer to a file, retrying short and interrupted writes.
+    in: fd - the file to write to
+    in: data - the bytes to write
+    in: size - the number of bytes
+*/
+static void writeAll(int fd, const void *data, size_t size) {
+    const char *buffer = (const char *)data;
+    while (size > 0) {
+        ssize_t written = write(fd, buffer, size);
+        if (written <= 0) {
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            return; // the file is gone, nothing left to tell
+        }
+        buffer += written;
+        size -= (size_t)written;
+    }
+}
+
+/*
+    Grows the trace file to hold at least needed bytes, doubling it each time. The
+    file is only ever extended, so processes growing it at once cannot shrink it,
+    and size is raised only once the bytes below it exist.
+    in: needed - the end of the reservation about to be written
+    return: C_TRUE if the file is large enough, C_FALSE if it cannot grow
+*/
+static int growTrace(unsigned long long needed) {
+    pthread_mutex_lock(&traceGrowLock);
+    unsigned long long size = atomic_load_explicit(&traceHeader->size, memory_order_acquire);
+    while (size < needed) {
+        unsigned long long grown = size + (size > TRACE_MAP_CHUNK ? size : TRACE_MAP_CHUNK);
+        if (grown > TRACE_MAP_RESERVE) {
+            grown = TRACE_MAP_RESERVE;
+        }
+        if (needed > grown || posix_fallocate(traceFd, 0, (off_t)grown) != 0) {
+            pthread_mutex_unlock(&traceGrowLock);
+            return C_FALSE;
+        }
+        while (size < grown && !atomic_compare_exchange_weak_explicit(&traceHeader->size, &size, grown,
+                                                                      memory_order_release, memory_order_acquire)) {
+        }
+        size = atomic_load_explicit(&traceHeader->size, memory_order_acquire);
+    }
+    pthread_mutex_unlock(&traceGrowLock);
+    return C_TRUE;
+}
+
+/*
+    Appends whole records to the trace: reserves their slots with one atomic add on
+    the shared end, copies them in, and publishes them by storing the first kind
+    byte last, so a reader never sees a reserved slot before it is filled. When the
+    file cannot grow to hold them the records are dropped with an error: slots of
+    theirs inside the file stay zero, for the decoder to count, and the ones past
+    its end are counted in the header's dropped.
+    in: records - the records to append, only the first of which needs a kind
+    in: count - the number of records
+*/
+static void appendTrace(const TraceRecordType *records, size_t count) {
+    unsigned long long bytes = count * sizeof(TraceRecordType);
+    unsigned long long offset = atomic_fetch_add_explicit(&traceHeader->end, bytes, memory_order_relaxed);
+    unsigned long long size = atomic_load_explicit(&traceHeader->size, memory_order_acquire);
+    if (offset + bytes > size && !growTrace(offset + bytes)) {
+        static atomic_int reported = C_FALSE;
+        if (!atomic_exchange(&reported, C_TRUE)) {
+            fprintf(stderr, "Error: Trace file is full, dropping records.\n");
+        }
+        size = atomic_load_explicit(&traceHeader->size, memory_order_acquire);
+        unsigned long long outside = offset >= size ? bytes : offset + bytes > size ? offset + bytes - size : 0;
+        atomic_fetch_add_explicit(&traceHeader->dropped, outside / sizeof(TraceRecordType), memory_order_relaxed);
+        return;
+    }
+
+    TraceRecordType *slot = (TraceRecordType *)((char *)traceHeader + offset);
+    memcpy((char *)slot + 1, (const char *)records + 1, bytes - 1);
+    __atomic_store_n(&slot->kind, records->kind, __ATOMIC_RELEASE);
+}
+
+/*
+    Appends a record to the trace, after the names interned since the last record.
+    Every name a record refers to was interned before the record was made, so its
+    name is always reserved ahead of it and the decoder knows it before its first use.
+    in: record - the record to trace
+*/
+static void traceRecord(const LogRecordType *record) {
+    if (atomic_load_explicit(&namesTraced, memory_order_acquire) < nameCount()) {
+        pthread_mutex_lock(&traceLock);
+        for (int count = nameCount(), next = atomic_load_explicit(&namesTraced, memory_order_relaxed); next < count; next++) {
+            TraceRecordType group[1 + MAX_STR / sizeof(TraceRecordType)];
+            const char *name = nameOf(next);
+            size_t length = strlen(name);
+
+            memset(group, 0, sizeof(group));
+            group[0].kind = LOG_TRACE_NAME;
+            group[0].detail = (uint8_t)length;
+            group[0].hunter = (uint8_t)next;
+            group[0].room = TRACE_NONE;
+            memcpy(&group[1], name, length);
+            appendTrace(group, 1 + (length + sizeof(TraceRecordType) - 1) / sizeof(TraceRecordType));
+            atomic_store_explicit(&namesTraced, next + 1, memory_order_release);
+        }
+        pthread_mutex_unlock(&traceLock);
+    }
+
+    TraceRecordType trace;
+    encodeTraceRecord(record, &trace);
+    appendTrace(&trace, 1);
+}
+
+/*
+    Writes out a batch of the log writer's lines to stdout.
+    in: buffer - whole lines
+    in: size - the number of bytes
+*/
+static void flushLogBuffer(const char *buffer, size_t size) {
+    if (size > 0) {
+        writeAll(STDOUT_FILENO, buffer, size);
+    }
+}
+
+/*
+    Logs one record on the calling thread, without the log writer.
+    in: record - the record to log
+    in: buffered - C_TRUE to print text lines through stdio, C_FALSE to write them straight out
+*/
+static void logDirect(const LogRecordType *record, int buffered) {
+    char line[LOG_LINE_MAX];
+    int length = formatLogRecord(record, line);
+    if (buffered) {
+        fputs(line, stdout);
+    } else {
+        writeAll(STDOUT_FILENO, line, (size_t)length);
+    }
+}
+
+/*
+    Gives the calling thread's ring back at thread exit, for the next thread to
+    claim. Records still in it keep their place in the merge, since anything logged
+    later by any thread is stamped later. Runs as the ring key's destructor.
+    in: param - the ring of the exiting thread
+*/
+static void releaseLogRing(void *param) {
+    LogRingType *ring = (LogRingType *)param;
+    atomic_store_explicit(&ring->owned, C_FALSE, memory_order_release);
+}
+
+/*
+    Creates the key whose destructor releases a thread's ring.
+*/
+static void createRingKey() {
+    pthread_key_create(&ringKey, releaseLogRing);
+}
+
+/*
+    Returns the calling thread's ring, claiming a free one on the thread's first record.
+    return: the ring, or NULL if every ring is owned by another thread
+*/
+static LogRingType *acquireLogRing() {
+    if (threadRing) {
+        return threadRing;
+    }
+    for (int i = 0; i < LOG_RINGS; i++) {
+        int expected = C_FALSE;
+        if (atomic_compare_exchange_strong_explicit(&logRings[i].owned, &expected, C_TRUE, memory_order_acquire, memory_order_relaxed)) {
+            threadRing = &logRings[i];
+            threadRing->tailSeen = atomic_load_explicit(&threadRing->tail, memory_order_relaxed);
+            pthread_setspecific(ringKey, threadRing);
+            return threadRing;
+        }
+    }
+    return NULL;
+}
+
+/*
+    Returns the monotonic clock in nanoseconds, the order the log writer merges rings in.
+*/
+static uint64_t logStamp() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/*
+    Stamps a record with the calling thread's clock and hands it to the log writer
+    through the thread's ring, waiting for space when the writer has fallen a
+    whole ring behind. The record is stamped with the time last, just before it is
+    queued, so every ring holds its records in stamp order. While the record is on
+    its way the ring's watermark holds the ring's last stamp, which the new stamp
+    cannot be earlier than, so the writer leaves everything stamped from then on
+    queued until the record is in. Traced records skip the writer and go straight
+    into the mapped trace, in the order their slots are reserved; without a writer
+    text lines are printed right away.
+    in/out: record - the record to log
+*/
+static void emitLog(LogRecordType *record) {
+    if (record->kind != LOG_GAME_RECORD) {
+        record->game = clockGame;
+    }
+    record->tick = clockTick;
+
+    if (traceHeader) {
+        traceRecord(record);
+        return;
+    }
+    if (!atomic_load_explicit(&writerRunning, memory_order_relaxed)) {
+        logDirect(record, C_TRUE);
+        return;
+    }
+
+    LogRingType *ring = acquireLogRing();
+    if (!ring) {
+        // Every ring is taken; one line or record per write still keeps them whole
+        logDirect(record, C_FALSE);
+        return;
+    }
+
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (head - ring->tailSeen == LOG_RING_RECORDS) {
+        ring->tailSeen = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->tailSeen == LOG_RING_RECORDS) {
+            sched_yield();
+        }
+    }
+    // The watermark has to be up before the clock is read, for mergeHorizon
+    atomic_store_explicit(&ring->watermark, ring->lastStamp, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    record->stamp = ring->lastStamp = logStamp();
+    ring->records[head & (LOG_RING_RECORDS - 1)] = *record;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    atomic_store_explicit(&ring->watermark, UINT64_MAX, memory_order_release);
+}
+
+/*
+    Formats one record into the writer's buffer as a text line, writing the buffer
+    out first when it cannot take another.
+    in: record - the record to format
+    in/out: buffer - the writer's output buffer of LOG_WRITE_BUFFER bytes
+    in/out: used - bytes already in the buffer
+*/
+static void bufferLogRecord(const LogRecordType *record, char *buffer, size_t *used) {
+    if (LOG_WRITE_BUFFER - *used < LOG_LINE_MAX) {
+        flushLogBuffer(buffer, *used);
+        *used = 0;
+    }
+    *used += (size_t)formatLogRecord(record, buffer + *used);
+}
+
+/*
+    Returns the stamp before which every record is already in its ring: the
+    current time, or the lowest watermark if a thread is queuing a record. A thread
+    whose watermark is read before it goes up reads the clock after this one did.
+    Call before reading the rings' heads.
+    return: the horizon of the next merge
+*/
+static uint64_t mergeHorizon() {
+    uint64_t horizon = logStamp();
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < LOG_RINGS; i++) {
+        uint64_t watermark = atomic_load_explicit(&logRings[i].watermark, memory_order_acquire);
+        if (watermark < horizon) {
+            horizon = watermark;
+        }
+    }
+    return horizon;
+}
+
+/*
+    Merges the records waiting in every ring into the writer's buffer in stamp
+    order. Each ring is already in stamp order, so the oldest record of the rings
+    still holding any comes next. Records stamped at or after horizon stay queued:
+    a thread may be queuing an older record that is not in its ring yet.
+    in: horizon - the stamp every record written has to be older than
+    in/out: buffer - the writer's output buffer of LOG_WRITE_BUFFER bytes
+    in/out: used - bytes already in the buffer
+    return: the number of records taken
+*/
+static int mergeLogRings(uint64_t horizon, char *buffer, size_t *used) {
+    LogRingType *rings[LOG_RINGS];
+    unsigned int tails[LOG_RINGS];
+    unsigned int heads[LOG_RINGS];
+    int active = 0;
+    for (int i = 0; i < LOG_RINGS; i++) {
+        unsigned int tail = atomic_load_explicit(&logRings[i].tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&logRings[i].head, memory_order_acquire);
+        if (tail != head) {
+            rings[active] = &logRings[i];
+            tails[active] = tail;
+            heads[active] = head;
+            active++;
+        }
+    }
+
+    int taken = 0;
+    while (active > 0) {
+        int oldest = 0;
+        for (int i = 1; i < active; i++) {
+            if (rings[i]->records[tails[i] & (LOG_RING_RECORDS - 1)].stamp <
+                rings[oldest]->records[tails[oldest] & (LOG_RING_RECORDS - 1)].stamp) {
+                oldest = i;
+            }
+        }
+        const LogRecordType *record = &rings[oldest]->records[tails[oldest] & (LOG_RING_RECORDS - 1)];
+        if (record->stamp >= horizon) {
+            break;
+        }
+        bufferLogRecord(record, buffer, used);
+        taken++;
+
+        if (++tails[oldest] == heads[oldest]) {
+            // The ring is empty for this pass; hand its slots back and drop it
+            atomic_store_explicit(&rings[oldest]->tail, tails[oldest], memory_order_release);
+            active--;
+            rings[oldest] = rings[active];
+            tails[oldest] = tails[active];
+            heads[oldest] = heads[active];
+        }
+    }
+    for (int i = 0; i < active; i++) {
+        atomic_store_explicit(&rings[i]->tail, tails[i], memory_order_release);
+    }
+    return taken;
+}
+
+/*
+    Body of the log writer thread. Merges the rings into one stream ordered by the
+    time each record was queued, writes it out in batches of whole lines, and
+    sleeps when little is queued. Records not older than the merge horizon wait for
+    a later pass, so the stream is in exact stamp order. After stopLogWriter every
+    thread has stopped logging, so the writer takes everything left and returns
+    once the rings are empty.
+*/
+static void *logWriter(void *param) {
+    (void)param;
+    char buffer[LOG_WRITE_BUFFER];
+    size_t used = 0;
+
+    for (;;) {
+        // Read before merging, so the last pass starts after the stop
+        int running = atomic_load_explicit(&writerRunning, memory_order_acquire);
+        uint64_t horizon = running ? mergeHorizon() : UINT64_MAX;
+        int taken = mergeLogRings(horizon, buffer, &used);
+        // Busy producers are drained straight away; otherwise records are left to
+        // pile up for a while, so the writer is not reading their heads all the time
+        if (taken >= LOG_RING_RECORDS / 4) {
+            continue;
+        }
+        flushLogBuffer(buffer, used);
+        used = 0;
+        if (taken == 0 && !running) {
+            return NULL;
+        }
+        usleep(LOG_WRITER_IDLE);
+    }
+}
+
+/*
+    Starts the log writer thread. From then on log lines are queued by the threads
+    that log them and printed by the writer. Does nothing unless text logging is on,
+    since traced records are copied into the trace by the threads themselves.
+*/
+void startLogWriter() {
+    if (!isLogging() || traceHeader || atomic_load(&writerRunning)) {
+        return;
+    }
+    pthread_once(&ringKeyOnce, createRingKey);
+
+    // The writer bypasses stdio, so anything printed so far has to go out first
+    fflush(stdout);
+    for (int i = 0; i < LOG_RINGS; i++) {
+        atomic_store(&logRings[i].watermark, UINT64_MAX);
+    }
+    atomic_store(&writerRunning, C_TRUE);
+    if (pthread_create(&writerThread, NULL, logWriter, NULL) != 0) {
+        fprintf(stderr, "Error: Failed to start the log writer, logging directly.\n");
+        atomic_store(&writerRunning, C_FALSE);
+    }
+}
+
+/*
+    Stops the log writer thread once it has printed every queued line. Later log
+    lines are printed directly again.
+*/
+void stopLogWriter() {
+    if (!atomic_load(&writerRunning)) {
+        return;
+    }
+    atomic_store(&writerRunning, C_FALSE);
+    pthread_join(writerThread, NULL);
+}
+
+/*
+    Sends the log to a binary trace file instead of stdout. The file is mapped
+    shared into a TRACE_MAP_RESERVE window, sized to TRACE_MAP_CHUNK and grown as
+    records are reserved, so appending a record costs no system call and another
+    process can follow the trace by mapping the file too. Opened before shards are
+    forked, every shard appends through the same mapping.
+    in: path - the trace file to create or truncate
+    return: C_TRUE if the file is mapped, C_FALSE otherwise
+*/
+int openTrace(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open trace file '%s'.\n", path);
+        return C_FALSE;
+    }
+    void *map = MAP_FAILED;
+    if (posix_fallocate(fd, 0, TRACE_MAP_CHUNK) == 0) {
+        map = mmap(NULL, TRACE_MAP_RESERVE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map trace file '%s'.\n", path);
+        close(fd);
+        return C_FALSE;
+    }
+
+    TraceHeaderType *header = (TraceHeaderType *)map;
+    header->magic = (TraceRecordType){ .hunter = TRACE_NONE, .room = TRACE_NONE,
+                                       .tick = sizeof(TraceRecordType), .game = TRACE_MAGIC };
+    atomic_init(&header->end, sizeof(TraceHeaderType));
+    atomic_init(&header->size, TRACE_MAP_CHUNK);
+    atomic_init(&header->dropped, 0);
+    header->unused = 0;
+    __atomic_store_n(&header->magic.kind, LOG_TRACE_HEADER, __ATOMIC_RELEASE);
+    traceFd = fd;
+    traceHeader = header;
+    atomic_store(&namesTraced, 0);
+    return C_TRUE;
+}
+
+/*
+    Marks the trace closed for anyone following it, cuts the file down to the
+    records reserved and unmaps it. Call once every thread and shard has stopped
+    logging; later lines go to stdout again.
+*/
+void closeTrace() {
+    if (!traceHeader) {
+        return;
+    }
+    unsigned long long end = atomic_load(&traceHeader->end);
+    unsigned long long size = atomic_load(&traceHeader->size);
+    __atomic_store_n(&traceHeader->magic.detail, TRACE_CLOSED, __ATOMIC_RELEASE);
+    if (ftruncate(traceFd, (off_t)(end < size ? end : size)) != 0) {
+        fprintf(stderr, "Error: Cannot trim the trace file.\n");
+    }
+    munmap(traceHeader, TRACE_MAP_RESERVE);
+    close(traceFd);
+    traceHeader = NULL;
+    traceFd = -1;
+}
+
+/*
     Logs the hunter being created.
-    in: hunter - the hunter name to log
+    in: hunter - the id of the hunter name to log
     in: equipment - the hunter's equipment
 */
-void l_hunterInit(char* hunter, enum EvidenceType equipment) {
-    if (!LOGGING) return;
-    char ev_str[MAX_STR];
-    evidenceToString(equipment, ev_str);
-    printf("[HUNTER INIT] [%s] is a [%s] hunter\n", hunter, ev_str);    
+void l_hunterInit(int hunter, enum EvidenceType equipment) {
+    if (!(logCategories & LOG_CAT_INIT)) return;
+    LogRecordType record = { .kind = LOG_HUNTER_INIT, .detail = equipment, .hunter = hunter, .room = -1 };
+    emitLog(&record);
 }
 
 /*
     Logs the hunter moving into a new room.
-    in: hunter - the hunter name to log
-    in: room - the room name to log
+    in: hunter - the id of the hunter name to log
+    in: room - the id of the room name to log
 */
-void l_hunterMove(char* hunter, char* room) {
-    if (!LOGGING) return;
-    printf("[HUNTER MOVE] [%s] has moved into [%s]\n", hunter, room);
+void l_hunterMove(int hunter, int room) {
+    if (!(logCategories & LOG_CAT_HUNTER_MOVE)) return;
+    LogRecordType record = { .kind = LOG_HUNTER_MOVE, .hunter = hunter, .room = room };
+    emitLog(&record);
 }
 
 /*
     Logs the hunter exiting the house.
-    in: hunter - the hunter name to log
+    in: hunter - the id of the hunter name to log
     in: reason - the reason for exiting, either LOG_FEAR, LOG_BORED, or LOG_EVIDENCE
 */
-void l_hunterExit(char* hunter, enum LoggerDetails reason) {
-    if (!LOGGING) return;
-    printf("[HUNTER EXIT] [%s] exited because ", hunter);
-    switch (reason) {
-        case LOG_FEAR:
-            printf("[FEAR]\n");
-            break;
-        case LOG_BORED:
-            printf("[BORED]\n");
-            break;
-        case LOG_EVIDENCE:
-            printf("[EVIDENCE]\n");
-            break;
-        default:
-            printf("[UNKNOWN]\n");
-    }
+void l_hunterExit(int hunter, enum LoggerDetails reason) {
+    if (!(logCategories & LOG_CAT_EXIT)) return;
+    LogRecordType record = { .kind = LOG_HUNTER_EXIT, .detail = reason, .hunter = hunter, .room = -1 };
+    emitLog(&record);
+}
+
+/*
+    Logs the hunter leaving the game after its fear or boredom ran out.
+    in: hunter - the id of the hunter name to log
+*/
+void l_hunterLeft(int hunter) {
+    if (!(logCategories & LOG_CAT_EXIT)) return;
+    LogRecordType record = { .kind = LOG_HUNTER_LEFT, .hunter = hunter, .room = -1 };
+    emitLog(&record);
 }
 
 /*
     Logs the hunter reviewing evidence.
-    in: hunter - the hunter name to log
+    in: hunter - the id of the hunter name to log
     in: result - the result of the review, either LOG_SUFFICIENT or LOG_INSUFFICIENT
 */
-void l_hunterReview(char* hunter, enum LoggerDetails result) {
-    if (!LOGGING) return;
-    printf("[HUNTER REVIEW] [%s] reviewed evidence and found ", hunter);
-    switch (result) {
-        case LOG_SUFFICIENT:
-            printf("[SUFFICIENT]\n");
-            break;
-        case LOG_INSUFFICIENT:
-            printf("[INSUFFICIENT]\n");
-            break;
-        default:
-            printf("[UNKNOWN]\n");
-    }
+void l_hunterReview(int hunter, enum LoggerDetails result) {
+    if (!(logCategories & LOG_CAT_REVIEW)) return;
+    LogRecordType record = { .kind = LOG_HUNTER_REVIEW, .detail = result, .hunter = hunter, .room = -1 };
+    emitLog(&record);
 }
 
 /*
     Logs the hunter collecting evidence.
-    in: hunter - the hunter name to log
+    in: hunter - the id of the hunter name to log
     in: evidence - the evidence type to log
-    in: room - the room name to log
+    in: room - the id of the room name to log
+*/
+void l_hunterCollect(int hunter, enum EvidenceType evidence, int room) {
+    if (!(logCategories & LOG_CAT_HUNTER_EVIDENCE)) return;
+    LogRecordType record = { .kind = LOG_HUNTER_COLLECT, .detail = evidence, .hunter = hunter, .room = room };
+    emitLog(&record);
+}
+
+/*
+    Logs a piece of evidence entering the shared evidence set.
+    in: evidence - the evidence type collected
+    in: count - the number of evidence types collected so far
 */
-void l_hunterCollect(char* hunter, enum EvidenceType evidence, char* room) {
-    if (!LOGGING) return;
-    char ev_str[MAX_STR];
-    evidenceToString(evidence, ev_str);
-    printf("[HUNTER EVIDENCE] [%s] found [%s] in [%s] and [COLLECTED]\n", hunter, ev_str, room);
+void l_evidenceCount(enum EvidenceType evidence, int count) {
+    if (!(logCategories & LOG_CAT_HUNTER_EVIDENCE)) return;
+    LogRecordType record = { .kind = LOG_EVIDENCE_COUNT, .detail = evidence, .hunter = -1, .room = -1, .count = count };
+    emitLog(&record);
 }
 
 /*
     Logs the ghost moving into a new room.
-    in: room - the room name to log
+    in: room - the id of the room name to log
 */
-void l_ghostMove(char* room) {
-    if (!LOGGING) return;
-    printf("[GHOST MOVE] Ghost has moved into [%s]\n", room);
+void l_ghostMove(int room) {
+    if (!(logCategories & LOG_CAT_GHOST_MOVE)) return;
+    LogRecordType record = { .kind = LOG_GHOST_MOVE, .hunter = -1, .room = room };
+    emitLog(&record);
 }
 
 /*
@@ -92,43 +696,55 @@ void l_ghostMove(char* room) {
     in: reason - the reason for exiting, either LOG_FEAR, LOG_BORED, or LOG_EVIDENCE
 */
 void l_ghostExit(enum LoggerDetails reason) {
-    if (!LOGGING) return;
-    printf("[GHOST EXIT] Exited because ");
-    switch (reason) {
-        case LOG_FEAR:
-            printf("[FEAR]\n");
-            break;
-        case LOG_BORED:
-            printf("[BORED]\n");
-            break;
-        case LOG_EVIDENCE:
-            printf("[EVIDENCE]\n");
-            break;
-        default:
-            printf("[UNKNOWN]\n");
-    }
+    if (!(logCategories & LOG_CAT_EXIT)) return;
+    LogRecordType record = { .kind = LOG_GHOST_EXIT, .detail = reason, .hunter = -1, .room = -1 };
+    emitLog(&record);
 }
 
 /*
     Logs the ghost leaving evidence in a room.
     in: evidence - the evidence type to log
-    in: room - the room name to log
+    in: room - the id of the room name to log
 */
-void l_ghostEvidence(enum EvidenceType evidence, char* room) {
-    if (!LOGGING) return;
-    char ev_str[MAX_STR];
-    evidenceToString(evidence, ev_str);
-    printf("[GHOST EVIDENCE] Ghost left [%s] in [%s]\n", ev_str, room);
+void l_ghostEvidence(enum EvidenceType evidence, int room) {
+    if (!(logCategories & LOG_CAT_GHOST_EVIDENCE)) return;
+    LogRecordType record = { .kind = LOG_GHOST_EVIDENCE, .detail = evidence, .hunter = -1, .room = room };
+    emitLog(&record);
 }
 
 /*
     Logs the ghost being created.
     in: ghost - the ghost type to log
-    in: room - the room name that the ghost is starting in
-*/
-void l_ghostInit(enum GhostClass ghost, char* room) {
-    if (!LOGGING) return;
-    char ghost_str[MAX_STR];
-    ghostToString(ghost, ghost_str);
-    printf("[GHOST INIT] Ghost is a [%s] in room [%s]\n", ghost_str, room);
-}
\ No newline at end of file
+    in: room - the id of the room name that the ghost is starting in, -1 for none
+*/
+void l_ghostInit(enum GhostClass ghost, int room) {
+    if (!(logCategories & LOG_CAT_INIT)) return;
+    LogRecordType record = { .kind = LOG_GHOST_INIT, .detail = ghost, .hunter = -1, .room = room };
+    emitLog(&record);
+}
+
+/*
+    Logs the thread the ghost runs on.
+    in: thread - the ghost thread's id
+*/
+void l_ghostThread(unsigned long thread) {
+    if (!(logCategories & LOG_CAT_INIT)) return;
+    LogRecordType record = { .kind = LOG_GHOST_THREAD, .thread = thread };
+    emitLog(&record);
+}
+
+/*
+    Queues a game's CSV record behind the game's log lines while the log writer prints
+    text, and writes it to the trace while tracing.
+    in: game - the zero based index of the game
+    in: result - the game's summary
+    return: C_TRUE if the record was queued for stdout, C_FALSE if the caller has to print it
+*/
+int l_gameRecord(long game, const GameResultType *result) {
+    int traced = traceHeader != NULL;
+    if (!traced && !atomic_load_explicit(&writerRunning, memory_order_relaxed)) return C_FALSE;
+    LogRecordType record = { .kind = LOG_GAME_RECORD, .game = game, .result = *result };
+    emitLog(&record);
+    // Traced games keep their records on stdout as well, where the log is not
+    return !traced;
+}
@@ -1,19 +1,37 @@
 #include "defs.h"
 
-int main() {
-    srand(time(NULL));
+int main(int argc, char *argv[]) {
+    // Any command line options select the non-interactive batch mode
+    if (argc > 1) {
+        BatchOptionsType options;
+        if (!parseBatchOptions(argc, argv, &options)) {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        if (options.bench) {
+            runRngBenchmark(&options);
+            return 0;
+        }
+        return runBatch(&options) ? 0 : EXIT_FAILURE;
+    }
+
+    // The interactive game logs everything unless the environment says otherwise
+    setLogCategories(logCategoriesFromEnv(LOG_CAT_ALL));
 
     HouseType house;
-    setupHouse(&house);
+    setupHouse(&house, (unsigned int)time(NULL), 0);
 
     GhostType *ghost = prepareGhost(&house);
 
     char hunterNames[NUM_HUNTERS][MAX_STR];
     inputHunterNames(hunterNames);
 
+    // The prompts are done, from here on the log writer prints the game log
+    startLogWriter();
+
     initializeHunters(&house, hunterNames);
 
-    assignRandomEquipment(house.hunterArray, house.hunterArray->size);
+    assignRandomEquipment(house.hunterArray, house.hunterArray->size, &house.rng);
     logHunterInitialization(house.hunterArray);
 
     SharedGameState gameState = {0};
@@ -22,26 +40,34 @@ int main() {
     setupThreads(&ghostThread, hunterThreads, &gameState, ghost, &house);
 
     waitForThreadsCompletion(ghostThread, hunterThreads);
+    stopLogWriter();
 
     evaluateGameOutcome(&house, ghost);
 
-    cleanupResources(ghost, &house);
+    freeHouse(&house);
     return 0;
 }
 
 /**
- * Sets up the house by initializing it and populating rooms.
+ * Sets up the house by initializing it, populating rooms and compiling the room graph.
  * 
  * Parameters:
  *   house - Pointer to HouseType structure to be set up.
+ *   seed - Master seed every random stream of the game derives from.
+ *   game - Index of the game within the run.
  */
-void setupHouse(HouseType *house) {
+void setupHouse(HouseType *house, unsigned int seed, long game) {
     initHouse(house);
+    house->seed = seed;
+    house->game = game;
+    rngInit(&house->rng, seed, game, RNG_STREAM_SETUP);
+    setLogClock(game, 0);
     populateRooms(house);
+    compileHouseLayout(house);
 }
 
 /**
- * Prepares a ghost by allocating memory and initializing it in a random room.
+ * Prepares a ghost by allocating it from the house's arena and initializing it in a random room.
  * 
  * Parameters:
  *   house - Pointer to HouseType structure containing the rooms.
@@ -50,9 +76,10 @@ void setupHouse(HouseType *house) {
  *   Pointer to the allocated and initialized GhostType.
  */
 GhostType* prepareGhost(HouseType *house) {
-    GhostType *ghost = malloc(sizeof(GhostType));
+    GhostType *ghost = (GhostType *)arenaAlloc(&house->arena, sizeof(GhostType));
     RoomType *randomRoom = getRandomRoomExcludeVan(house);
-    initGhost(ghost, randomGhost(), randomRoom);
+    initGhost(ghost, randomGhost(&house->rng), randomRoom);
+    rngInit(&ghost->rng, house->seed, house->game, RNG_STREAM_GHOST);
     return ghost;
 }
 
@@ -71,19 +98,21 @@ void inputHunterNames(char names[][MAX_STR]) {
 }
 
 /**
- * Initializes hunters and adds them to the house and van room.
+ * Initializes hunters, adds them to the house and marks them in the van room.
  * 
  * Parameters:
  *   house - Pointer to HouseType structure.
  *   names - Two-dimensional array containing hunter names.
  */
 void initializeHunters(HouseType *house, char names[][MAX_STR]) {
-    RoomType *vanRoom = house->rooms->rhead->room;
+    RoomType *vanRoom = house->startRoom;
     for (int i = 0; i < NUM_HUNTERS; i++) {
         HunterType hunter;
-        initHunter(&hunter, names[i], EV_UNKNOWN, vanRoom);
+        initHunter(house, &hunter, names[i], EV_UNKNOWN, vanRoom);
+        rngInit(&hunter.rng, house->seed, house->game, RNG_STREAM_HUNTER + i);
+        hunter.index = i;
         addHunter(house->hunterArray, &hunter);
-        addHunter(vanRoom->hunterArray, &hunter);
+        atomic_fetch_or(&vanRoom->hunters, HUNTER_BIT(i));
     }
 }
 
@@ -95,12 +124,13 @@ void initializeHunters(HouseType *house, char names[][MAX_STR]) {
  */
 void logHunterInitialization(HunterArrayType *hunterArray) {
     for (int i = 0; i < hunterArray->size; i++) {
-        l_hunterInit(hunterArray->hunter[i].name, hunterArray->hunter[i].equipment);
+        l_hunterInit(hunterArray->hunter[i].info->nameId, hunterArray->hunter[i].equipment);
     }
 }
 
 /**
- * Sets up and starts threads for the ghost and each hunter.
+ * Sets up and starts threads for the ghost and each hunter. Their contexts live in
+ * the house's arena, so they must be joined before the house is freed.
  * 
  * Parameters:
  *   ghostThread - Pointer to pthread_t for the ghost thread.
@@ -110,12 +140,12 @@ void logHunterInitialization(HunterArrayType *hunterArray) {
  *   house - Pointer to HouseType structure.
  */
 void setupThreads(pthread_t *ghostThread, pthread_t hunterThreads[], SharedGameState *gameState, GhostType *ghost, HouseType *house) {
-    GhostBehaviorContext *ghostContext = malloc(sizeof(GhostBehaviorContext));
+    GhostBehaviorContext *ghostContext = (GhostBehaviorContext *)arenaAlloc(&house->arena, sizeof(GhostBehaviorContext));
     initGhostBehavior(ghostContext, ghost, house, house->hunterArray, gameState);
     pthread_create(ghostThread, NULL, ghostBehaviour, (void *)ghostContext);
 
     for (int i = 0; i < NUM_HUNTERS; i++) {
-        HunterBehaviorContext *hunterContext = malloc(sizeof(HunterBehaviorContext));
+        HunterBehaviorContext *hunterContext = (HunterBehaviorContext *)arenaAlloc(&house->arena, sizeof(HunterBehaviorContext));
         hunterContext->hunter = &house->hunterArray->hunter[i];
         hunterContext->ghosts = ghost;
         hunterContext->house = house;
@@ -146,20 +176,64 @@ void waitForThreadsCompletion(pthread_t ghostThread, pthread_t hunterThreads[])
  *   ghost - Pointer to GhostType structure.
  */
 void evaluateGameOutcome(HouseType *house, GhostType *ghost) {
-    int fear_count = 0;
-    int boredom_count_hunter = 0;
+    GameResultType result;
+    tallyGameOutcome(house, ghost, &result);
 
     printf("=================================\n");
     printf("All done! Let's tally the results...\n");
     printf("=================================\n");
 
-    // Analyze each hunter's fear 
+    // Report each hunter's fear 
     if (house->hunterArray->size == 0) {
         printf("There are no hunters left in the house.\n");
+    } else {
+        for (int i = 0; i < house->hunterArray->size; i++) {
+            printf("%s's fear level is %d\n", nameOf(house->hunterArray->hunter[i].info->nameId), house->hunterArray->hunter[i].fear);
+        }
+    }
+
+    // Report each hunter's boredom
+    for (int i = 0; i < house->hunterArray->size; i++) {
+        printf("%s's boredom level is %d\n", nameOf(house->hunterArray->hunter[i].info->nameId), house->hunterArray->hunter[i].boredom);
+    }
+
+    // Print ghost's boredom level
+    printf("The ghost's boredom level is %d\n", ghost->boredomTime);
+
+    // Review evidence
+    reviewEv(house->evidenceArray, ghost);
+
+    // Report the game's outcome
+    switch (result.outcome) {
+        case OUTCOME_GHOST_WINS:
+            printf("The ghost has won the game!\n");
+            break;
+        case OUTCOME_HUNTERS_WIN:
+            printf("The hunters have won the game!\n");
+            break;
+        default:
+            printf("The ghost got bored and left.\n");
+            break;
+    }
+}
+
+/**
+ * Tallies the outcome of the game without printing anything.
+ * 
+ * Parameters:
+ *   house - Pointer to HouseType structure.
+ *   ghost - Pointer to GhostType structure.
+ *   result - Output parameter receiving the game's summary.
+ */
+void tallyGameOutcome(HouseType *house, GhostType *ghost, GameResultType *result) {
+    int fear_count = 0;
+    int boredom_count_hunter = 0;
+
+    // Analyze each hunter's fear 
+    if (house->hunterArray->size == 0) {
         fear_count = NUM_HUNTERS;
     } else {
         for (int i = 0; i < house->hunterArray->size; i++) {
-            printf("%s's fear level is %d\n", house->hunterArray->hunter[i].name, house->hunterArray->hunter[i].fear);
             if (house->hunterArray->hunter[i].fear >= 100) {
                 fear_count++;
             }
@@ -168,37 +242,25 @@ void evaluateGameOutcome(HouseType *house, GhostType *ghost) {
 
     // Analyze each hunter's boredom
     for (int i = 0; i < house->hunterArray->size; i++) {
-        printf("%s's boredom level is %d\n", house->hunterArray->hunter[i].name, house->hunterArray->hunter[i].boredom);
         if (house->hunterArray->hunter[i].boredom >= 100) {
             boredom_count_hunter++;
         }
     }
 
-    // Print ghost's boredom level
-    printf("The ghost's boredom level is %d\n", ghost->boredomTime);
-
-    // Review evidence
-    reviewEv(house->evidenceArray, ghost);
+    result->ghostType = ghost->ghostType;
+    result->ghostBoredom = ghost->boredomTime;
+    result->fearfulHunters = fear_count;
+    result->boredHunters = boredom_count_hunter;
+    unsigned int evidence = atomic_load(&house->evidenceArray->mask);
+    result->evidenceCount = __builtin_popcount(evidence);
+    result->identified = (result->evidenceCount == 3) ? identifyGhostFromMask(evidence) : GH_UNKNOWN;
 
     // Determine the game's outcome
     if (fear_count == NUM_HUNTERS || boredom_count_hunter == NUM_HUNTERS) {
-        printf("The ghost has won the game!\n");
-    } else if (house->evidenceArray->size == 3 && ghost->boredomTime < 100) {
-        printf("The hunters have won the game!\n");
+        result->outcome = OUTCOME_GHOST_WINS;
+    } else if (result->evidenceCount == 3 && ghost->boredomTime < 100) {
+        result->outcome = OUTCOME_HUNTERS_WIN;
     } else {
-        printf("The ghost got bored and left.\n");
+        result->outcome = OUTCOME_GHOST_LEFT;
     }
 }
-
-
-/**
- * Cleans up and frees allocated resources.
- * 
- * Parameters:
- *   ghost - Pointer to GhostType to be freed.
- *   house - Pointer to HouseType structure to be freed.
- */
-void cleanupResources(GhostType *ghost, HouseType *house) {
-    freeGhost(ghost);
-    freeHouse(house);
-}
\ No newline at end of file
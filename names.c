@@ -0,0 +1,76 @@
+#include "defs.h"
+
+// Every room and hunter name of the process, stored once and referred to by index.
+// Names are appended under the lock and published by the release store of the count.
+static char nameStrings[MAX_NAMES][MAX_STR];
+static atomic_int namesInterned = 0;
+static pthread_mutex_t nameLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Returns the id of a name, adding a copy of it to the name table if it is new.
+ * The table is shared by every house of the process and only ever grows, so an
+ * id stays valid after its house is freed and the log writer can still turn it
+ * into a string. Names are only interned while a house is set up, so a linear
+ * search is enough; the game itself only ever passes the ids around. Exits the
+ * program if the table is full.
+ *
+ * Parameters:
+ *   name - The name to intern, cut to MAX_STR - 1 characters.
+ *
+ * Returns:
+ *   int - The name's index in the table.
+ */
+int internName(const char *name) {
+    int count = atomic_load_explicit(&namesInterned, memory_order_acquire);
+    for (int id = 0; id < count; id++) {
+        if (strncmp(nameStrings[id], name, MAX_STR - 1) == 0) {
+            return id;
+        }
+    }
+
+    // Houses set up on other threads may be adding names at the same time
+    pthread_mutex_lock(&nameLock);
+    int id = count;
+    count = atomic_load_explicit(&namesInterned, memory_order_relaxed);
+    for (; id < count; id++) {
+        if (strncmp(nameStrings[id], name, MAX_STR - 1) == 0) {
+            pthread_mutex_unlock(&nameLock);
+            return id;
+        }
+    }
+    if (count == MAX_NAMES) {
+        fprintf(stderr, "Error: Name table is full.\n");
+        exit(EXIT_FAILURE);
+    }
+    strncpy(nameStrings[count], name, MAX_STR - 1);
+    nameStrings[count][MAX_STR - 1] = '\0';
+    atomic_store_explicit(&namesInterned, count + 1, memory_order_release);
+    pthread_mutex_unlock(&nameLock);
+    return count;
+}
+
+/**
+ * Returns the string of an interned name.
+ *
+ * Parameters:
+ *   id - The id returned by internName.
+ *
+ * Returns:
+ *   const char* - The name, or "No Room" for an id the table does not hold.
+ */
+const char *nameOf(int id) {
+    if (id < 0 || id >= atomic_load_explicit(&namesInterned, memory_order_acquire)) {
+        return "No Room";
+    }
+    return nameStrings[id];
+}
+
+/**
+ * Returns the number of names interned so far. Ids below it are valid.
+ *
+ * Returns:
+ *   int - The size of the name table.
+ */
+int nameCount() {
+    return atomic_load_explicit(&namesInterned, memory_order_acquire);
+}
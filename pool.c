@@ -0,0 +1,176 @@
+#include "defs.h"
+
+/**
+ * Returns the number of online cores, used to size the pool for --workers auto.
+ */
+int defaultWorkerCount() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+/**
+ * Plays the batch on a pool of worker threads, one whole game at a time.
+ *
+ * Every worker owns a queue holding a contiguous slice of the game indices.
+ * Owners take games from the front of their own queue; an idle worker steals
+ * the back half of another worker's queue, so uneven game lengths balance out
+ * without any central queue. Game threads are never created per game unless
+ * the threaded engine is selected.
+ *
+ * Parameters:
+ *   options - Pointer to the parsed batch options.
+ *   stats - Pointer to the statistics receiving every game's result.
+ */
+void runGamePool(BatchOptionsType *options, GameStatsType *stats) {
+    GamePoolType pool;
+    pool.options = options;
+    pool.workers = options->workers;
+
+    pool.queues = (GameQueueType *)malloc(sizeof(GameQueueType) * pool.workers);
+    PoolWorkerType *workers = (PoolWorkerType *)malloc(sizeof(PoolWorkerType) * pool.workers);
+    if (!pool.queues || !workers) {
+        fprintf(stderr, "Error: Failed to allocate memory for the game pool.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Deal the games out in contiguous slices
+    for (int i = 0; i < pool.workers; i++) {
+        pool.queues[i].next = options->games * i / pool.workers;
+        pool.queues[i].end = options->games * (i + 1) / pool.workers;
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+    }
+
+    for (int i = 0; i < pool.workers; i++) {
+        workers[i].pool = &pool;
+        workers[i].index = i;
+        memset(&workers[i].stats, 0, sizeof(GameStatsType));
+        if (pthread_create(&workers[i].thread, NULL, poolWorker, &workers[i]) != 0) {
+            fprintf(stderr, "Error: Failed to start pool worker %d.\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (int i = 0; i < pool.workers; i++) {
+        pthread_join(workers[i].thread, NULL);
+        mergeGameStats(stats, &workers[i].stats);
+    }
+
+    for (int i = 0; i < pool.workers; i++) {
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    }
+    free(workers);
+    free(pool.queues);
+}
+
+/**
+ * Thread function for a pool worker. Plays games from its own queue and
+ * steals from the others until no queue has any games left.
+ *
+ * Parameters:
+ *   param - A pointer to the worker's PoolWorkerType.
+ *
+ * Returns: None.
+ */
+void *poolWorker(void *param) {
+    PoolWorkerType *worker = (PoolWorkerType *)param;
+    GamePoolType *pool = worker->pool;
+    GameQueueType *queue = &pool->queues[worker->index];
+
+    // The struct-of-arrays engine takes a whole lane set of games at a time
+    GameLanesType *lanes = NULL;
+    long chunk = 1;
+    if (pool->options->engine == ENGINE_SOA) {
+        lanes = createGameLanes(pool->options->lanes);
+        if (!lanes) {
+            exit(EXIT_FAILURE);
+        }
+        chunk = lanes->lanes;
+    }
+
+    long first;
+    for (;;) {
+        long count = takeGames(queue, chunk, &first);
+        if (count == 0) {
+            if (!stealGames(pool, worker->index)) {
+                break; // nothing left anywhere, no new games are ever queued
+            }
+            continue;
+        }
+
+        if (lanes) {
+            playGameLanes(lanes, pool->options, first, count, &worker->stats);
+            continue;
+        }
+
+        GameResultType result;
+        playGame(pool->options, first, &result);
+        printGameRecord(first, &result);
+        addGameResult(&worker->stats, &result);
+    }
+
+    freeGameLanes(lanes);
+    releaseArenaCache();
+    return NULL;
+}
+
+/**
+ * Takes up to max consecutive games from the front of a queue.
+ *
+ * Parameters:
+ *   queue - Pointer to the queue to take from.
+ *   max - The most games to take.
+ *   first - Output parameter receiving the index of the first game taken.
+ *
+ * Returns:
+ *   long - The number of games taken, 0 if the queue was empty.
+ */
+long takeGames(GameQueueType *queue, long max, long *first) {
+    long taken = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->next < queue->end) {
+        taken = queue->end - queue->next < max ? queue->end - queue->next : max;
+        *first = queue->next;
+        queue->next += taken;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return taken;
+}
+
+/**
+ * Moves the back half of the first non-empty queue into the thief's queue.
+ *
+ * Parameters:
+ *   pool - Pointer to the game pool.
+ *   thief - Index of the idle worker.
+ *
+ * Returns:
+ *   int - 1 if any games were stolen, 0 if every queue was empty.
+ */
+int stealGames(GamePoolType *pool, int thief) {
+    for (int offset = 1; offset < pool->workers; offset++) {
+        GameQueueType *victim = &pool->queues[(thief + offset) % pool->workers];
+        long first = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        long remaining = victim->end - victim->next;
+        if (remaining > 0) {
+            end = victim->end;
+            first = end - (remaining + 1) / 2;
+            victim->end = first;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (end > first) {
+            GameQueueType *own = &pool->queues[thief];
+            pthread_mutex_lock(&own->lock);
+            own->next = first;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "defs.h"
+
+#define PHILOX_M0       0xD2511F53u
+#define PHILOX_M1       0xCD9E8D57u
+#define PHILOX_W0       0x9E3779B9u             // key schedule increments
+#define PHILOX_W1       0xBB67AE85u
+#define PHILOX_KEY_HI   0x47484F53u             // second key word, the seed is the first
+
+/*
+    Runs the ten Philox4x32 rounds on one counter. Written on plain words so
+    the bulk loop in philoxFill can vectorize it.
+        in:   key - the two key words
+        in:   counter - the four counter words
+        out:  out - the four random words
+*/
+static inline void philoxBlock(const unsigned int key[2], const unsigned int counter[4], unsigned int out[4]) {
+    unsigned int c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    unsigned int k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        unsigned long long p0 = (unsigned long long)PHILOX_M0 * c0;
+        unsigned long long p1 = (unsigned long long)PHILOX_M1 * c2;
+        c0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (unsigned int)p1;
+        c2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (unsigned int)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+/*
+    Fills the Philox4x32-10 key of a run from its master seed.
+        in:   seed - the master seed of the run
+        out:  key - the two key words
+*/
+void rngKey(unsigned int seed, unsigned int key[2]) {
+    key[0] = seed;
+    key[1] = PHILOX_KEY_HI;
+}
+
+/*
+    Generates the random words of many counters at once. Counter i gives the
+    four words out[i], the same words rngNext would draw from that block, so
+    callers can lay out one counter per game and fill a whole batch in one loop
+    the compiler vectorizes.
+        in:   key - the run's key, from rngKey
+        in:   counters - n counters of {block, stream, game low, game high}
+        out:  out - n blocks of four random words
+        in:   n - the number of counters
+*/
+void philoxFill(const unsigned int key[2], const unsigned int (*restrict counters)[4], unsigned int (*restrict out)[4], int n) {
+    for (int i = 0; i < n; i++) {
+        philoxBlock(key, counters[i], out[i]);
+    }
+}
+
+/*
+    Starts the random stream of one entity of one game. A stream is a counter-based
+    Philox4x32-10 generator: block b of the stream is the hash of the counter
+    {b, stream, game} under the key of the seed, so any block of any game can be
+    generated directly, in any order and on any thread.
+        out:  rng - the stream to start
+        in:   seed - the master seed of the run
+        in:   game - the game's index within the run
+        in:   stream - RNG_STREAM_SETUP, RNG_STREAM_GHOST or RNG_STREAM_HUNTER + i
+*/
+void rngInit(RngType *rng, unsigned int seed, long game, int stream) {
+    rngKey(seed, rng->key);
+    rng->counter[0] = 0;
+    rng->counter[1] = (unsigned int)stream;
+    rng->counter[2] = (unsigned int)((unsigned long long)game & 0xFFFFFFFFu);
+    rng->counter[3] = (unsigned int)((unsigned long long)game >> 32);
+    rng->used = RNG_BLOCK_WORDS;
+}
+
+/*
+    Moves a stream on to its next block. Entities call this once at the start of
+    every action, so action n always draws from block n whatever earlier actions drew.
+        in/out: rng - the stream to advance
+*/
+void rngNextBlock(RngType *rng) {
+    philoxBlock(rng->key, rng->counter, rng->block);
+    rng->counter[0]++;
+    rng->used = 0;
+}
+
+/*
+    Returns the next 32 random bits of a stream, moving on to the next block once
+    the current one is used up.
+        in/out: rng - the stream to draw from
+    return:   32 random bits
+*/
+unsigned int rngNext(RngType *rng) {
+    if (rng->used == RNG_BLOCK_WORDS) {
+        rngNextBlock(rng);
+    }
+    return rng->block[rng->used++];
+}
+
+/*
+    Returns a pseudo randomly generated number, in the range min to (max - 1), inclusively.
+    Uses Lemire's multiply-shift on the integer draw: the high half of word * range is the
+    result, and the rare words that would favour the low end of the range are redrawn, so
+    every value is exactly equally likely.
+        in/out: rng - the stream to draw from
+        in:   lower end of the range of the generated number
+        in:   upper end of the range of the generated number
+    return:   randomly generated integer in the range [min, max)
+*/
+int rngInt(RngType *rng, int min, int max)
+{
+    unsigned int range = (unsigned int)(max - min);
+    unsigned long long product = (unsigned long long)rngNext(rng) * range;
+
+    if ((unsigned int)product < range) {
+        unsigned int threshold = (0u - range) % range;
+        while ((unsigned int)product < threshold) {
+            product = (unsigned long long)rngNext(rng) * range;
+        }
+    }
+
+    return min + (int)(product >> 32);
+}
+
+/*
+    Returns a pseudo randomly generated floating point number.
+        in/out: rng - the stream to draw from
+        in:   lower end of the range of the generated number
+        in:   upper end of the range of the generated number
+    return:   randomly generated floating point number in the range [min, max)
+*/
+float rngFloat(RngType *rng, float min, float max) {
+    float random = RNG_UNIT(rngNext(rng));
+    float diff = max - min;
+    float r = random * diff;
+    return min + r;
+}
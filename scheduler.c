@@ -0,0 +1,84 @@
+#include "defs.h"
+
+/**
+ * Plays a whole game on the calling thread using a fixed-tick scheduler.
+ *
+ * One tick stands for GHOST_WAIT microseconds of the threaded game: the ghost
+ * acts on every tick and each hunter on every HUNTER_TICKS-th tick, keeping the
+ * HUNTER_WAIT / GHOST_WAIT ratio without ever sleeping. Entities always act in
+ * the same order (ghost first, then hunters by index), so a game is fully
+ * determined by the seed and game index its random streams derive from.
+ *
+ * Parameters:
+ *   house - A pointer to the HouseType structure, with hunters already placed.
+ *   ghost - A pointer to the GhostType structure.
+ *   sharedState - A pointer to the SharedGameState for this game.
+ *
+ * Returns:
+ *   long - The number of ticks the game lasted.
+ */
+long runGameTicked(HouseType *house, GhostType *ghost, SharedGameState *sharedState) {
+    if (!house || !ghost || !sharedState) {
+        fprintf(stderr, "Error: Invalid parameter(s) provided to runGameTicked.\n");
+        return 0;
+    }
+
+    HunterArrayType *hunters = house->hunterArray;
+    int active[NUM_HUNTERS];
+    for (int i = 0; i < NUM_HUNTERS; i++) {
+        active[i] = (i < hunters->size);
+    }
+
+    long tick = 0;
+    for (; !sharedState->gameOver; tick++) {
+        setLogClock(house->game, tick);
+        if (!updateGhost(ghost, hunters, hunters->size, sharedState)) {
+            break; // the ghost got bored and left
+        }
+
+        if (tick % HUNTER_TICKS != 0) {
+            continue;
+        }
+
+        for (int i = 0; i < hunters->size && !sharedState->gameOver; i++) {
+            if (!active[i]) {
+                continue;
+            }
+
+            if (!updateHunterState(&hunters->hunter[i], ghost, house, house->evidenceArray, sharedState)) {
+                active[i] = C_FALSE; // the hunter has left the house
+                continue;
+            }
+
+            if (house->hunterCount == 0 || countEvidence(house->evidenceArray) >= 3) {
+                sharedState->gameOver = 1;
+            }
+        }
+    }
+
+    return tick;
+}
+
+/**
+ * Plays a whole game on the calling thread as fast as possible.
+ *
+ * Turns off semaphore locking for the duration of the game, then interleaves
+ * the ghost and hunter updates in the fixed-tick loop of runGameTicked.
+ * Nothing sleeps and no entity ever exits a thread.
+ *
+ * Parameters:
+ *   house - A pointer to the HouseType structure, with hunters already placed.
+ *   ghost - A pointer to the GhostType structure.
+ *
+ * Returns:
+ *   long - The number of ticks the game lasted.
+ */
+long runGameInline(HouseType *house, GhostType *ghost) {
+    SharedGameState sharedState = {0};
+
+    setSynchronized(C_FALSE);
+    long ticks = runGameTicked(house, ghost, &sharedState);
+    setSynchronized(C_TRUE);
+
+    return ticks;
+}
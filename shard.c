@@ -0,0 +1,102 @@
+#include "defs.h"
+
+/**
+ * Plays the batch in separate worker processes.
+ *
+ * Every shard is a forked copy of the process that plays one contiguous slice
+ * of the game indices on its own, so the process-wide generator, logging and
+ * stdout state is never shared between shards. Shards print their records
+ * line by line and leave their statistics in a MAP_SHARED region that the
+ * parent adds up once every shard has exited. A shard that crashes or exits
+ * early loses only its own slice, which is reported on stderr.
+ *
+ * Parameters:
+ *   options - Pointer to the parsed batch options.
+ *   stats - Pointer to the statistics receiving every finished shard's result.
+ *
+ * Returns:
+ *   int - The number of shards that failed.
+ */
+int runGameShards(BatchOptionsType *options, GameStatsType *stats) {
+    int shards = options->shards;
+    size_t size = sizeof(ShardSlotType) * shards;
+
+    ShardSlotType *slots = (ShardSlotType *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pid_t *pids = (pid_t *)malloc(sizeof(pid_t) * shards);
+    if (slots == MAP_FAILED || !pids) {
+        fprintf(stderr, "Error: Failed to allocate memory for the shards.\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(slots, 0, size);
+
+    // Anything still buffered would otherwise be printed once per shard
+    fflush(stdout);
+    fflush(stderr);
+
+    for (int i = 0; i < shards; i++) {
+        slots[i].first = options->games * i / shards;
+        slots[i].end = options->games * (i + 1) / shards;
+
+        pids[i] = fork();
+        if (pids[i] < 0) {
+            // The slot keeps its range, so the report below names the games not played
+            fprintf(stderr, "Error: Failed to start shard %d (games %ld-%ld).\n", i, slots[i].first, slots[i].end - 1);
+            continue;
+        }
+        if (pids[i] == 0) {
+            free(pids);
+            shardWorker(options, &slots[i]);
+        }
+    }
+
+    int failed = 0;
+    for (int i = 0; i < shards; i++) {
+        int status = 0;
+        if (pids[i] > 0 && waitpid(pids[i], &status, 0) < 0) {
+            status = -1;
+        }
+
+        if (pids[i] > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0 && slots[i].finished) {
+            mergeGameStats(stats, &slots[i].stats);
+            continue;
+        }
+
+        failed++;
+        if (pids[i] > 0 && WIFSIGNALED(status)) {
+            fprintf(stderr, "Error: Shard %d (games %ld-%ld) was killed by signal %d.\n",
+                    i, slots[i].first, slots[i].end - 1, WTERMSIG(status));
+        } else {
+            fprintf(stderr, "Error: Shard %d (games %ld-%ld) did not finish.\n", i, slots[i].first, slots[i].end - 1);
+        }
+    }
+
+    munmap(slots, size);
+    free(pids);
+    return failed;
+}
+
+/**
+ * Body of a forked shard. Plays the shard's slice of games, stores its
+ * statistics in the shared slot and exits without returning to the caller.
+ *
+ * Parameters:
+ *   options - Pointer to the parsed batch options.
+ *   slot - Pointer to the shard's slot in the shared region.
+ */
+void shardWorker(BatchOptionsType *options, ShardSlotType *slot) {
+    // Whole lines keep records of concurrent shards from being cut in half
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    // The log writer's writes of at most PIPE_BUF bytes of whole lines do the same for the log
+    startLogWriter();
+
+    GameStatsType stats = {0};
+    if (slot->end > slot->first) {
+        playGameRange(options, slot->first, slot->end - slot->first, &stats);
+    }
+    stopLogWriter();
+    fflush(stdout);
+
+    slot->stats = stats;
+    slot->finished = C_TRUE;
+    _exit(0);
+}
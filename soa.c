@@ -0,0 +1,405 @@
+#include "defs.h"
+
+/*
+    Maps a random word to [0, range) with the same multiply-shift rngInt uses.
+*/
+static inline unsigned int laneRange(unsigned int word, unsigned int range) {
+    return (unsigned int)(((unsigned long long)word * range) >> 32);
+}
+
+/*
+    Checks whether rngInt would redraw the word for the given range and threshold.
+*/
+static inline int laneRejects(unsigned int word, unsigned int range, unsigned int threshold) {
+    return (unsigned int)((unsigned long long)word * range) < threshold;
+}
+
+/**
+ * Allocates a struct-of-arrays engine that steps up to SOA_LANES games in
+ * lockstep. Lane i of every per-game array belongs to the same game, so each
+ * step is a straight loop over lanes the compiler can vectorize. The house
+ * layout is taken from populateRooms once and shared by every lane.
+ *
+ * Parameters:
+ *   laneCount - The number of games stepped together.
+ *
+ * Returns:
+ *   GameLanesType* - The new engine, or NULL if allocation failed.
+ */
+GameLanesType *createGameLanes(int laneCount) {
+    if (laneCount <= 0 || laneCount > SOA_LANES) {
+        fprintf(stderr, "Error: Invalid lane count (%d).\n", laneCount);
+        return NULL;
+    }
+
+    GameLanesType *lanes = (GameLanesType *)calloc(1, sizeof(GameLanesType));
+    if (!lanes) {
+        fprintf(stderr, "Error: Memory allocation for game lanes failed.\n");
+        return NULL;
+    }
+    lanes->lanes = laneCount;
+
+    initLaneTopology(lanes);
+
+    return lanes;
+}
+
+/**
+ * Copies the compiled adjacency of a freshly set up house: rooms keep their
+ * ids and each room's connections start at neighbourStart[room].
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType being created.
+ */
+void initLaneTopology(GameLanesType *lanes) {
+    HouseType house;
+    setupHouse(&house, 0, 0);
+
+    if (house.roomCount > MAX_LANE_ROOMS) {
+        fprintf(stderr, "Error: The struct-of-arrays engine supports at most %d rooms.\n", MAX_LANE_ROOMS);
+        exit(EXIT_FAILURE);
+    }
+
+    lanes->rooms = house.roomCount;
+    lanes->van = house.startRoom->id;
+    lanes->spawnCount = house.spawnCount;
+    for (int r = 0; r <= house.roomCount; r++) {
+        lanes->neighbourStart[r] = house.adjacencyStart[r];
+    }
+    for (int e = 0; e < house.adjacencyStart[house.roomCount]; e++) {
+        lanes->neighbours[e] = house.adjacency[e]->id;
+    }
+    for (int r = 0; r < house.roomCount; r++) {
+        unsigned int degree = (unsigned int)house.roomTable[r]->neighbourCount;
+        lanes->neighbourThreshold[r] = degree ? (0u - degree) % degree : 0;
+    }
+    for (int s = 0; s < house.spawnCount; s++) {
+        lanes->spawnRooms[s] = house.spawnRooms[s]->id;
+    }
+
+    freeHouse(&house);
+}
+
+/**
+ * Frees a struct-of-arrays engine.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType to be freed.
+ */
+void freeGameLanes(GameLanesType *lanes) {
+    if (!lanes) {
+        return;
+    }
+
+    free(lanes);
+}
+
+/**
+ * Plays a range of consecutive games in lockstep. Every HUNTER_TICKS ticks the
+ * lanes whose game is over are tallied, printed and refilled with the next
+ * game of the range, so long games never hold the other lanes back. Lanes left
+ * without a game are masked out of every step.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType to play on.
+ *   options - A pointer to the batch options.
+ *   first - Index of the first game.
+ *   count - Number of games to play.
+ *   stats - Pointer to the statistics receiving every game's result.
+ */
+void playGameLanes(GameLanesType *lanes, BatchOptionsType *options, long first, long count, GameStatsType *stats) {
+    if (!lanes || !options || !stats || count <= 0) {
+        fprintf(stderr, "Error: Invalid parameter(s) provided to playGameLanes.\n");
+        return;
+    }
+
+    long next = first;
+    long end = first + count;
+    rngKey(options->seed, lanes->key);
+    for (int l = 0; l < lanes->lanes; l++) {
+        lanes->game[l] = -1;
+        lanes->active[l] = 0;
+    }
+
+    // New games only join at a hunter tick so every lane keeps the schedule of runGameTicked
+    for (long tick = 0; ; tick++) {
+        if (tick % HUNTER_TICKS == 0) {
+            int running = 0;
+            for (int l = 0; l < lanes->lanes; l++) {
+                if (lanes->active[l]) {
+                    running++;
+                    continue;
+                }
+                if (lanes->game[l] >= 0) {
+                    GameResultType result;
+                    tallyLaneOutcome(lanes, l, &result);
+                    printGameRecord(lanes->game[l], &result);
+                    addGameResult(stats, &result);
+                    lanes->game[l] = -1;
+                }
+                if (next < end) {
+                    initLane(lanes, l, options->seed, next++, tick);
+                    running++;
+                }
+            }
+            if (running == 0) {
+                break;
+            }
+        }
+
+        fillLaneDraws(lanes, tick, RNG_STREAM_GHOST, 1);
+        stepGhostLanes(lanes);
+        if (tick % HUNTER_TICKS == 0) {
+            for (int h = 0; h < NUM_HUNTERS; h++) {
+                fillLaneDraws(lanes, tick, RNG_STREAM_HUNTER + h, HUNTER_TICKS);
+                stepHunterLanes(lanes, h);
+            }
+        }
+    }
+}
+
+/**
+ * Sets up one lane the way setupHouse, prepareGhost, initializeHunters and
+ * assignRandomEquipment set up a game, drawing from the same setup stream, so
+ * a lane starts exactly like the scalar engines start the same game.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType.
+ *   l - The lane to set up.
+ *   seed - Master seed of the batch.
+ *   game - Index of the game played in the lane.
+ *   tick - Tick the game starts at.
+ */
+void initLane(GameLanesType *lanes, int l, unsigned int seed, long game, long tick) {
+    RngType setup;
+    rngInit(&setup, seed, game, RNG_STREAM_SETUP);
+
+    lanes->game[l] = game;
+    lanes->start[l] = tick;
+    lanes->counters[l][2] = (unsigned int)((unsigned long long)game & 0xFFFFFFFFu);
+    lanes->counters[l][3] = (unsigned int)((unsigned long long)game >> 32);
+    lanes->active[l] = 1;
+
+    lanes->ghostRoom[l] = lanes->spawnRooms[rngInt(&setup, 0, lanes->spawnCount)];
+    lanes->ghostClass[l] = randomGhost(&setup);
+    lanes->ghostBoredom[l] = 0;
+
+    // Every hunter carries a different piece of equipment
+    int assigned[EV_COUNT] = {0};
+    for (int h = 0; h < NUM_HUNTERS; h++) {
+        int equipment;
+        do {
+            equipment = rngInt(&setup, 0, EV_COUNT);
+        } while (assigned[equipment]);
+        assigned[equipment] = 1;
+
+        lanes->hunterRoom[h][l] = lanes->van;
+        lanes->hunterFear[h][l] = 0;
+        lanes->hunterBoredom[h][l] = 0;
+        lanes->hunterActive[h][l] = 1;
+        lanes->hunterEquipment[h][l] = equipment;
+    }
+    lanes->hunterCount[l] = NUM_HUNTERS;
+    lanes->evidenceMask[l] = 0;
+    lanes->evidenceCount[l] = 0;
+    lanes->roomEvidence[l] = 0;
+}
+
+/**
+ * Generates the random block every lane's entity draws from in this step: the
+ * block an entity acting every period ticks uses for its current action, the
+ * same block its rngNextBlock call picks in the scalar engines.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType.
+ *   tick - The current tick.
+ *   stream - The entity's stream, RNG_STREAM_GHOST or RNG_STREAM_HUNTER + i.
+ *   period - Ticks between two actions of the entity.
+ */
+void fillLaneDraws(GameLanesType *lanes, long tick, int stream, int period) {
+    for (int l = 0; l < lanes->lanes; l++) {
+        lanes->counters[l][0] = (unsigned int)((tick - lanes->start[l]) / period);
+        lanes->counters[l][1] = (unsigned int)stream;
+    }
+    philoxFill(lanes->key, (const unsigned int (*)[RNG_BLOCK_WORDS])lanes->counters, lanes->draws, lanes->lanes);
+}
+
+/**
+ * Performs updateGhost on every running lane: presence check, boredom, and a
+ * random choice between idling, leaving evidence and moving away.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType.
+ */
+void stepGhostLanes(GameLanesType *lanes) {
+    const int n = lanes->lanes;
+    // Local copies of the layout cannot alias the lane arrays, which lets the loop vectorize
+    int start[MAX_LANE_ROOMS + 1], neighbours[MAX_LANE_ROOMS * MAX_LANE_ROOMS];
+    unsigned int threshold[MAX_LANE_ROOMS];
+    memcpy(start, lanes->neighbourStart, sizeof(start));
+    memcpy(neighbours, lanes->neighbours, sizeof(neighbours));
+    memcpy(threshold, lanes->neighbourThreshold, sizeof(threshold));
+    int evidenceTable[GHOST_COUNT * 4];     // ghostEvidence flattened, a lookup is class * 4 + draw
+    for (int i = 0; i < GHOST_COUNT * 4; i++) {
+        evidenceTable[i] = ghostEvidence[i / 4][i % 4];
+    }
+    const unsigned int threeThreshold = (0u - 3u) % 3u;
+    const unsigned int (*draws)[RNG_BLOCK_WORDS] = lanes->draws;
+    int *active = lanes->active;
+    int *ghostRoom = lanes->ghostRoom;
+    int *ghostBoredom = lanes->ghostBoredom;
+    const int *ghostClass = lanes->ghostClass;
+    unsigned long long *roomEvidence = lanes->roomEvidence;
+
+    for (int l = 0; l < n; l++) {
+        int live = active[l];
+        int room = ghostRoom[l];
+
+        // isHunterPresent counts every hunter, including ones that already left
+        int present = 0;
+        for (int h = 0; h < NUM_HUNTERS; h++) {
+            present |= (lanes->hunterRoom[h][l] == room);
+        }
+
+        int boredom = present ? 0 : ghostBoredom[l] + 1;
+        ghostBoredom[l] = live ? boredom : ghostBoredom[l];
+        int acts = live & (boredom < BOREDOM_MAX);
+        active[l] = acts;
+
+        // Like updateGhost: the first accepted word picks the action, the next one the
+        // evidence or the room, each skipping a word rngInt would have redrawn
+        unsigned int w0 = draws[l][0], w1 = draws[l][1], w2 = draws[l][2], w3 = draws[l][3];
+        unsigned int skip = laneRejects(w0, 3, threeThreshold);
+        unsigned int actionWord = skip ? w1 : w0;
+        unsigned int detailWord = skip ? w2 : w1;
+        unsigned int spareWord = skip ? w3 : w2;
+        int action = (int)laneRange(actionWord, 3);
+
+        // Leave evidence in the current room
+        unsigned int evidenceWord = laneRejects(detailWord, 3, threeThreshold) ? spareWord : detailWord;
+        int evidence = evidenceTable[ghostClass[l] * 4 + (int)laneRange(evidenceWord, 3)];
+        unsigned long long drop = (unsigned long long)(acts & (action == 1));
+        roomEvidence[l] |= drop << (room * LANE_ROOM_BITS + evidence);
+
+        // Move to a random connected room, like moveToRandomRoomGhost
+        unsigned int degree = (unsigned int)(start[room + 1] - start[room]);
+        unsigned int moveWord = laneRejects(detailWord, degree, threshold[room]) ? spareWord : detailWord;
+        int target = neighbours[start[room] + (int)laneRange(moveWord, degree)];
+        int moves = acts & (action == 2) & !present & (degree > 0);
+        ghostRoom[l] = moves ? target : room;
+    }
+}
+
+/**
+ * Performs updateHunterState on one hunter of every running lane: fear and
+ * boredom, leaving the house, then moving, collecting or reviewing evidence.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType.
+ *   h - The hunter's index.
+ */
+void stepHunterLanes(GameLanesType *lanes, int h) {
+    const int n = lanes->lanes;
+    // Local copies of the layout cannot alias the lane arrays, which lets the loop vectorize
+    int start[MAX_LANE_ROOMS + 1], neighbours[MAX_LANE_ROOMS * MAX_LANE_ROOMS];
+    unsigned int threshold[MAX_LANE_ROOMS];
+    memcpy(start, lanes->neighbourStart, sizeof(start));
+    memcpy(neighbours, lanes->neighbours, sizeof(neighbours));
+    memcpy(threshold, lanes->neighbourThreshold, sizeof(threshold));
+    const unsigned int threeThreshold = (0u - 3u) % 3u;
+    const unsigned int (*draws)[RNG_BLOCK_WORDS] = lanes->draws;
+    int *active = lanes->active;
+    const int *ghostRoom = lanes->ghostRoom;
+    int *hunterRoom = lanes->hunterRoom[h];
+    int *hunterFear = lanes->hunterFear[h];
+    int *hunterBoredom = lanes->hunterBoredom[h];
+    int *hunterActive = lanes->hunterActive[h];
+    const int *hunterEquipment = lanes->hunterEquipment[h];
+    int *hunterCount = lanes->hunterCount;
+    int *evidenceMask = lanes->evidenceMask;
+    int *evidenceCount = lanes->evidenceCount;
+    const unsigned long long *roomEvidence = lanes->roomEvidence;
+
+    for (int l = 0; l < n; l++) {
+        int live = active[l] & hunterActive[l];
+        int room = hunterRoom[l];
+        int scared = (room == ghostRoom[l]);
+
+        // Fear rises and boredom resets next to the ghost, boredom rises anywhere else
+        int fear = hunterFear[l] + (scared & (hunterFear[l] < FEAR_MAX));
+        int boredom = (hunterBoredom[l] + (hunterBoredom[l] < BOREDOM_MAX)) & -!scared;
+        hunterFear[l] = live ? fear : hunterFear[l];
+        hunterBoredom[l] = live ? boredom : hunterBoredom[l];
+
+        int leaves = live & ((fear >= FEAR_MAX) | (boredom >= BOREDOM_MAX));
+        int count = hunterCount[l] - leaves;
+        hunterCount[l] = count;
+        int acts = live & !leaves;
+
+        // Like performHunterAction: the first accepted word picks the action, the next one the room
+        unsigned int w0 = draws[l][0], w1 = draws[l][1], w2 = draws[l][2], w3 = draws[l][3];
+        unsigned int skip = laneRejects(w0, 3, threeThreshold);
+        unsigned int actionWord = skip ? w1 : w0;
+        unsigned int detailWord = skip ? w2 : w1;
+        unsigned int spareWord = skip ? w3 : w2;
+        int action = (int)laneRange(actionWord, 3);
+
+        // Move to a random connected room
+        unsigned int degree = (unsigned int)(start[room + 1] - start[room]);
+        unsigned int moveWord = laneRejects(detailWord, degree, threshold[room]) ? spareWord : detailWord;
+        int target = neighbours[start[room] + (int)laneRange(moveWord, degree)];
+        hunterRoom[l] = (acts & (action == 0) & (degree > 0)) ? target : room;
+
+        // Collect evidence matching the equipment if the shared set has room for it
+        int bit = 1 << hunterEquipment[l];
+        int found = ((int)(roomEvidence[l] >> (room * LANE_ROOM_BITS)) & bit) != 0;
+        int collects = acts & (action == 1) & found & ((evidenceMask[l] & bit) == 0) & (evidenceCount[l] < MAX_EV);
+        evidenceMask[l] |= bit & -collects;
+        evidenceCount[l] += collects;
+
+        // Review: like isSufficientEvidence only EMF, TEMPERATURE and FINGERPRINTS count
+        int sufficient = (evidenceMask[l] & SUFFICIENT_EVIDENCE) == SUFFICIENT_EVIDENCE;
+        int reviewsOut = acts & (action == 2) & sufficient;
+        hunterActive[l] = hunterActive[l] & !leaves & !reviewsOut;
+
+        // Game over once the house is empty or three pieces of evidence are in
+        int over = (leaves & (count == 0)) | ((acts & !reviewsOut) & ((count == 0) | (evidenceCount[l] >= 3)));
+        active[l] = active[l] & !over;
+    }
+}
+
+/**
+ * Tallies a finished lane the same way tallyGameOutcome tallies a game.
+ *
+ * Parameters:
+ *   lanes - A pointer to the GameLanesType.
+ *   l - The lane to tally.
+ *   result - Output parameter receiving the game's summary.
+ */
+void tallyLaneOutcome(GameLanesType *lanes, int l, GameResultType *result) {
+    int fearCount = 0;
+    int boredCount = 0;
+    for (int h = 0; h < NUM_HUNTERS; h++) {
+        fearCount += lanes->hunterFear[h][l] >= 100;
+        boredCount += lanes->hunterBoredom[h][l] >= 100;
+    }
+
+    result->ghostType = (GhostClass)lanes->ghostClass[l];
+    result->ghostBoredom = lanes->ghostBoredom[l];
+    result->fearfulHunters = fearCount;
+    result->boredHunters = boredCount;
+    result->evidenceCount = lanes->evidenceCount[l];
+    result->identified = GH_UNKNOWN;
+
+    if (lanes->evidenceCount[l] == 3) {
+        result->identified = identifyGhostFromMask((unsigned int)lanes->evidenceMask[l]);
+    }
+
+    if (fearCount == NUM_HUNTERS || boredCount == NUM_HUNTERS) {
+        result->outcome = OUTCOME_GHOST_WINS;
+    } else if (lanes->evidenceCount[l] == 3 && lanes->ghostBoredom[l] < 100) {
+        result->outcome = OUTCOME_HUNTERS_WIN;
+    } else {
+        result->outcome = OUTCOME_GHOST_LEFT;
+    }
+}
@@ -1,97 +1,45 @@
 #include "defs.h"
 
-/*
-    Returns a pseudo randomly generated number, in the range min to (max - 1), inclusively
-        in:   lower end of the range of the generated number
-        in:   upper end of the range of the generated number
-    return:   randomly generated integer in the range [0, max-1) 
-*/
-int randInt(int min, int max)
-{
-    return (int) randFloat(min, max);
-}
+static __thread int syncDisabled = C_FALSE;
 
 /*
-    Returns a pseudo randomly generated floating point number.
-    A few tricks to make this thread safe, just to reduce any chance of issues using random
-        in:   lower end of the range of the generated number
-        in:   upper end of the range of the generated number
-    return:   randomly generated floating point number in the range [min, max)
+    Turns semaphore locking on or off for the calling thread. Engines that play a whole
+    game on one thread switch it off; threads start with locking on.
+        in:   enabled - C_TRUE to lock shared game structures, C_FALSE to skip locking
 */
-float randFloat(float min, float max) {
-    static __thread unsigned int seed = 0;
-    if (seed == 0) {
-        seed = (unsigned int)time(NULL) ^ (unsigned int)pthread_self();
-    }
-
-    float random = ((float) rand_r(&seed)) / (float) RAND_MAX;
-    float diff = max - min;
-    float r = random * diff;
-    return min + r;
+void setSynchronized(int enabled) {
+    syncDisabled = !enabled;
 }
 
-/* 
-    Returns a random enum GhostClass.
+/*
+    Waits on a game structure's semaphore unless locking is off for the calling thread.
+        in:   sem - the semaphore guarding the structure
+    return:   the result of sem_wait, or 0 when locking is off
 */
-enum GhostClass randomGhost() {
-    return (enum GhostClass) randInt(0, GHOST_COUNT);
+int syncWait(sem_t *sem) {
+    return syncDisabled ? 0 : sem_wait(sem);
 }
 
-
 /*
-    Returns the string representation of the given enum EvidenceType.
-        in: type - the enum EvidenceType to convert
-        out: str - the string representation of the given enum EvidenceType, minimum 16 characters
+    Posts a game structure's semaphore unless locking is off for the calling thread.
+        in:   sem - the semaphore guarding the structure
+    return:   the result of sem_post, or 0 when locking is off
 */
-void evidenceToString(enum EvidenceType type, char* str) {
-    switch (type) {
-        case EMF:
-            strcpy(str, "EMF");
-            break;
-        case TEMPERATURE:
-            strcpy(str, "TEMPERATURE");
-            break;
-        case FINGERPRINTS:
-            strcpy(str, "FINGERPRINTS");
-            break;
-        case SOUND:
-            strcpy(str, "SOUND");
-            break;
-        default:
-            strcpy(str, "UNKNOWN");
-            break;
-    }
+int syncPost(sem_t *sem) {
+    return syncDisabled ? 0 : sem_post(sem);
 }
 
 /* 
-    Returns the string representation of the given enum GhostClass.
-        in: ghost - the enum GhostClass to convert
-        out: buffer - the string representation of the given enum GhostClass, minimum 16 characters
+    Returns a random enum GhostClass.
 */
-void ghostToString(enum GhostClass ghost, char* buffer) {
-    switch(ghost) {
-        case BANSHEE:
-            strcpy(buffer, "Banshee");
-            break;
-        case BULLIES:
-            strcpy(buffer, "Bullies");
-            break;
-        case PHANTOM:
-            strcpy(buffer, "Phantom");
-            break;
-        case POLTERGEIST:
-            strcpy(buffer, "Poltergeist");
-            break;
-        default:
-            strcpy(buffer, "Unknown");
-            break;
-        
-    }
+enum GhostClass randomGhost(RngType *rng) {
+    return (enum GhostClass) rngInt(rng, 0, GHOST_COUNT);
 }
 
 
 /*
-    Checks if a hunter is present in the same room as the ghost.
+    Checks if a hunter is present in the same room as the ghost, by reading the
+    occupancy word of the ghost's room.
 
     @param ghost - A pointer to the GhostType struct.
     @param list - A pointer to the HunterArrayType struct.
@@ -104,14 +52,8 @@ int isHunterPresent(GhostType* ghost, HunterArrayType* list, int numHunters) {
         return 0; // Indicates no hunter is present
     }
 
-    // Iterate through the list of hunters
-    for (int i = 0; i < list->size; ++i) {
-        if (isSameRoom(ghost->room, list->hunter[i].room)) {
-            return 1; // Indicates a hunter is present in the same room
-        }
-    }
-
-    return 0; // Indicates no hunter is present in the same room
+    // Hunters that left the game still occupy the room they left from
+    return ghost->room != NULL && atomic_load_explicit(&ghost->room->hunters, memory_order_relaxed) != 0;
 }
 
 /**
@@ -129,20 +71,6 @@ int isValidGhostAndHunterList(GhostType* ghost, HunterArrayType* list, int numHu
     return ghost != NULL && list != NULL && list->size > 0 && numHunters > 0;
 }
 
-/**
- * Checks if two rooms are the same.
- *
- * Parameters:
- *   room1 - Pointer to the first RoomType structure.
- *   room2 - Pointer to the second RoomType structure.
- *
- * Returns:
- *   An integer, 1 if rooms are the same, 0 otherwise.
- */
-int isSameRoom(RoomType* room1, RoomType* room2) {
-    return room1 != NULL && room2 != NULL && room1 == room2;
-}
-
 /**
  * Checks if a ghost is present in the same room as a hunter.
  *
@@ -171,27 +99,13 @@ int isGhostPresent(GhostType* ghost, HunterType *hunter) {
  * Returns: None.
  */
 void moveToRandomRoomGhost(GhostType *ghost) {
-    if (!ghost || !ghost->room || !ghost->room->roomlist) {
+    if (!ghost || !ghost->room || ghost->room->neighbourCount == 0) {
         fprintf(stderr, "Error: Invalid ghost or room in repositionGhost.\n");
         return;
     }
 
-    RoomListType *roomList = ghost->room->roomlist;
-    int targetIndex = randInt(0, roomList->size - 1); 
-    RoomNodeType *targetRoomNode = roomList->rhead;
-
-
-    for (int i = 0; i < targetIndex && targetRoomNode; i++) {
-        targetRoomNode = targetRoomNode->next;
-    }
-
-
-    if (targetRoomNode) {
-        ghost->room = targetRoomNode->room;
-    } else {
-        fprintf(stderr, "Error: Target room not found in repositionGhost.\n");
-    }
-
+    int targetIndex = rngInt(&ghost->rng, 0, ghost->room->neighbourCount);
+    ghost->room = getRoomAtIndex(ghost->room, targetIndex);
 }
 
 
@@ -211,10 +125,9 @@ void moveToRandomRoomHunter(HunterType *hunter, HouseType *house) {
         return;
     }
 
-    RoomListType *roomList = hunter->room->roomlist;
-    int targetRoomIndex = getRandomRoomIndex(roomList->size);
+    int targetRoomIndex = getRandomRoomIndex(hunter->room->neighbourCount, &hunter->rng);
 
-    RoomType *newRoom = getRoomAtIndex(roomList, targetRoomIndex);
+    RoomType *newRoom = getRoomAtIndex(hunter->room, targetRoomIndex);
     
     if (newRoom) {
         updateHunterLocation(hunter, newRoom);
@@ -233,28 +146,24 @@ int isHunterAndHouseValid(HunterType *hunter, HouseType *house) {
 /**
  * Gets a random index for a room.
  */
-int getRandomRoomIndex(int roomCount) {
-    return randInt(0, roomCount - 1);
+int getRandomRoomIndex(int roomCount, RngType *rng) {
+    return rngInt(rng, 0, roomCount);
 }
 
 /**
- * Retrieves a room at a specific index in the room list.
+ * Retrieves the connected room at a specific index of a room's adjacency.
  */
-RoomType* getRoomAtIndex(RoomListType *roomList, int index) {
-    RoomNodeType *current = roomList->rhead;
-    for (int i = 0; i < index && current; i++) {
-        current = current->next;
-    }
-    return current ? current->room : NULL;
+RoomType* getRoomAtIndex(RoomType *room, int index) {
+    return (index >= 0 && index < room->neighbourCount) ? room->neighbours[index] : NULL;
 }
 
 /**
- * Updates the location of the hunter to the new room.
+ * Updates the location of the hunter to the new room, moving its occupancy bit.
  */
 void updateHunterLocation(HunterType *hunter, RoomType *newRoom) {
-    removeHunter(hunter->room->hunterArray, hunter); // Assuming removeHunter function exists
+    atomic_fetch_and_explicit(&hunter->room->hunters, ~HUNTER_BIT(hunter->index), memory_order_relaxed);
     hunter->room = newRoom;
-    addHunter(newRoom->hunterArray, hunter); // Assuming addHunter function exists
+    atomic_fetch_or_explicit(&newRoom->hunters, HUNTER_BIT(hunter->index), memory_order_relaxed);
 }
 
 
@@ -274,15 +183,12 @@ RoomType* getRandomRoomExcludeVan(HouseType *house) {
         return NULL;
     }
 
-    int totalRooms = countNonVanRooms(house->rooms);
-
-    if (totalRooms <= 0) {
+    if (house->spawnCount <= 0) {
         fprintf(stderr, "Error: No valid rooms available apart from 'Van'.\n");
         return NULL;
     }
 
-    int randomIndex = rand() % totalRooms;
-    return findRoomByIndex(house->rooms, randomIndex);
+    return house->spawnRooms[rngInt(&house->rng, 0, house->spawnCount)];
 }
 
 /**
@@ -291,35 +197,3 @@ RoomType* getRandomRoomExcludeVan(HouseType *house) {
 int isValidHouse(HouseType *house) {
     return house != NULL && house->rooms != NULL && house->rooms->rhead != NULL;
 }
-
-/**
- * Counts the number of rooms excluding the 'Van' room.
- */
-int countNonVanRooms(RoomListType *roomList) {
-    int count = 0;
-    RoomNodeType *current = roomList->rhead;
-    while (current) {
-        if (strcmp(current->room->name, "Van") != 0) {
-            count++;
-        }
-        current = current->next;
-    }
-    return count;
-}
-
-/**
- * Finds and returns the room at a specific index, excluding 'Van'.
- */
-RoomType* findRoomByIndex(RoomListType *roomList, int index) {
-    RoomNodeType *current = roomList->rhead;
-    while (current) {
-        if (strcmp(current->room->name, "Van") != 0) {
-            if (index == 0) {
-                return current->room;
-            }
-            index--;
-        }
-        current = current->next;
-    }
-    return NULL;
-}
\ No newline at end of file